@@ -0,0 +1,1003 @@
+/*
+ * tinycode throughput and latency benchmarks.
+ * Copyright (C) <2018>  Crs Chin<crs.chin@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * usage: tinybench [-t msec] [-f filter] [output]
+ *
+ * every case runs for at least msec (default 100) and one line is
+ * written per case, in CSV, to stdout and to output if given:
+ *
+ *   name,corpus,bytes,iterations,ns_per_call,mb_per_s
+ *
+ * bytes is the input size of a single call, MB is 10^6 bytes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tinycode.h"
+
+#ifndef ARRAYSIZE
+ #define ARRAYSIZE(a)  (sizeof(a)/sizeof(a[0]))
+#endif
+
+#define PREVIEW_CHARS   40
+
+struct buf {
+    unsigned char *data;
+    size_t len;
+};
+
+/* a corpus in every coding the cases need */
+struct corpus {
+    const char *name;
+    struct buf utf8;
+    struct buf utf16be;
+    struct buf utf16le;
+    struct buf latin1;          /* empty unless every code point fits */
+    struct buf gsm7;            /* packed septets */
+    struct buf gsm8;            /* unpacked septets */
+    int septets;
+    char *list;                 /* delimited list */
+};
+
+struct bench_arg {
+    const struct corpus *c;
+    int from, to;
+    int single, locking;
+    void *out;
+    size_t out_sz;
+    tiny_decode_cache *cache;
+    tiny_cbs_assembler *cbs;
+};
+
+typedef void (*bench_fn)(const struct bench_arg *arg);
+
+static unsigned long bench_ns = 100 * 1000000UL;
+static const char *bench_filter;
+static FILE *bench_out;
+static volatile unsigned long bench_sink;
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void bench_run(const char *name, const char *corpus, size_t bytes,
+                      bench_fn fn, const struct bench_arg *arg)
+{
+    unsigned long long start, elapsed, iters = 0, batch = 1, i;
+    double ns, mbs;
+    char line[256];
+
+    if(bench_filter && ! strstr(name, bench_filter))
+        return;
+
+    /* warm up */
+    fn(arg);
+
+    start = now_ns();
+    do {
+        for(i = 0; i < batch; i++)
+            fn(arg);
+        iters += batch;
+        if(batch < (1 << 20))
+            batch *= 2;
+    } while((elapsed = now_ns() - start) < bench_ns);
+
+    ns = (double)elapsed / iters;
+    mbs = bytes ? (double)bytes * iters * 1000.0 / elapsed : 0.0;
+
+    snprintf(line, sizeof(line), "%s,%s,%zu,%llu,%.1f,%.1f\n",
+             name, corpus, bytes, iters, ns, mbs);
+    fputs(line, stdout);
+    if(bench_out)
+        fputs(line, bench_out);
+}
+
+/* corpora */
+
+static void buf_reserve(struct buf *b, size_t n)
+{
+    b->data = (unsigned char *)realloc(b->data, b->len + n);
+    if(! b->data)  {
+        printf("OOM growing corpus!\n");
+        exit(1);
+    }
+}
+
+static void put_utf8(struct buf *b, unsigned int cp)
+{
+    unsigned char *p;
+
+    buf_reserve(b, 4);
+    p = b->data + b->len;
+    if(cp <= 0x7F)  {
+        p[0] = cp;
+        b->len += 1;
+    } else if(cp <= 0x7FF)  {
+        p[0] = 0xC0 | (cp >> 6);
+        p[1] = 0x80 | (cp & 0x3F);
+        b->len += 2;
+    } else if(cp <= 0xFFFF)  {
+        p[0] = 0xE0 | (cp >> 12);
+        p[1] = 0x80 | ((cp >> 6) & 0x3F);
+        p[2] = 0x80 | (cp & 0x3F);
+        b->len += 3;
+    } else  {
+        p[0] = 0xF0 | (cp >> 18);
+        p[1] = 0x80 | ((cp >> 12) & 0x3F);
+        p[2] = 0x80 | ((cp >> 6) & 0x3F);
+        p[3] = 0x80 | (cp & 0x3F);
+        b->len += 4;
+    }
+}
+
+static void put_utf16(struct buf *b, unsigned int cp, int be)
+{
+    unsigned int u[2];
+    int i, n = 1;
+
+    u[0] = cp;
+    if(cp > 0xFFFF)  {
+        cp -= 0x10000;
+        u[0] = 0xD800 | (cp >> 10);
+        u[1] = 0xDC00 | (cp & 0x3FF);
+        n = 2;
+    }
+
+    buf_reserve(b, 4);
+    for(i = 0; i < n; i++)  {
+        b->data[b->len++] = be ? (u[i] >> 8) : (u[i] & 0xFF);
+        b->data[b->len++] = be ? (u[i] & 0xFF) : (u[i] >> 8);
+    }
+}
+
+static unsigned int next_rand(unsigned int *seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return (*seed >> 16) & 0x7FFF;
+}
+
+/* code point generators per script */
+static unsigned int script_ascii(unsigned int r)  { return 0x20 + r % 0x5F; }
+static unsigned int script_latin(unsigned int r)  { return (r & 3) ? 0x20 + r % 0x5F : 0xC0 + r % 0x40; }
+static unsigned int script_cjk(unsigned int r)    { return 0x4E00 + r % 0x5000; }
+static unsigned int script_emoji(unsigned int r)  { return (r & 1) ? 0x1F600 + r % 0x50 : 0x20 + r % 0x5F; }
+
+static void gen_text(struct corpus *c, unsigned int (*script)(unsigned int), size_t cps)
+{
+    unsigned int seed = 0x5EED, cp, wide = 0;
+    size_t i;
+
+    buf_reserve(&c->latin1, cps);
+    for(i = 0; i < cps; i++)  {
+        cp = script(next_rand(&seed));
+        put_utf8(&c->utf8, cp);
+        put_utf16(&c->utf16be, cp, 1);
+        put_utf16(&c->utf16le, cp, 0);
+        c->latin1.data[c->latin1.len++] = cp;
+        wide |= cp > 0xFF;
+    }
+    if(wide)
+        c->latin1.len = 0;
+}
+
+static void gen_gsm(struct corpus *c, int septets)
+{
+    unsigned int seed = 0x6517, v, bit;
+    int i;
+
+    c->septets = septets;
+    buf_reserve(&c->gsm8, septets);
+    c->gsm7.len = (septets * 7 + 7) / 8;
+    c->gsm7.data = (unsigned char *)calloc(1, c->gsm7.len + 1);
+    if(! c->gsm7.data)  {
+        printf("OOM generating corpus!\n");
+        exit(1);
+    }
+
+    for(i = 0; i < septets; i++)  {
+        v = next_rand(&seed) & 0x7F;
+        /* escapes are rare, and never the last septet */
+        if(v == 0x1B && (i == septets - 1 || next_rand(&seed) % 8))
+            v = 0x20;
+        c->gsm8.data[c->gsm8.len++] = v;
+
+        bit = i * 7;
+        c->gsm7.data[bit / 8] |= v << (bit % 8);
+        if(bit % 8 > 1)
+            c->gsm7.data[bit / 8 + 1] |= v >> (8 - bit % 8);
+    }
+}
+
+static void gen_list(struct corpus *c, int items)
+{
+    unsigned int seed = 0x1157;
+    size_t len = 0;
+    int i;
+
+    c->list = (char *)malloc(items * 16 + 1);
+    if(! c->list)  {
+        printf("OOM generating corpus!\n");
+        exit(1);
+    }
+
+    for(i = 0; i < items; i++)
+        len += sprintf(c->list + len, "%s1380%03u%04u", i ? "," : "",
+                       next_rand(&seed) % 1000, next_rand(&seed) % 10000);
+    c->list[len] = '\0';
+}
+
+static int load_file(struct buf *b, const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    long sz;
+
+    if(! fp)
+        return -1;
+
+    fseek(fp, 0, SEEK_END);
+    sz = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf_reserve(b, sz);
+    b->len = fread(b->data, 1, sz, fp);
+    fclose(fp);
+    return 0;
+}
+
+/* cases */
+
+static void do_utf_convert(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    void *i = in->data, *o = a->out;
+    size_t in_sz = in->len, out_sz = a->out_sz;
+
+    bench_sink += tiny_utf_convert(a->from, &i, &in_sz, a->to, &o, &out_sz);
+}
+
+static void do_utf_convert_replace(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    void *i = in->data, *o = a->out;
+    size_t in_sz = in->len, out_sz = a->out_sz, nsubst;
+
+    bench_sink += tiny_utf_convert_ex(a->from, &i, &in_sz, a->to, &o, &out_sz,
+                                      UTF_CONV_REPLACE, 0, &nsubst) + nsubst;
+}
+
+/* single byte codings read the LATIN1 text, CP1252 included */
+static void do_sbcs_convert(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be
+        : a->from == UTF_CODING_UTF16LE ? &a->c->utf16le : &a->c->latin1;
+    void *i = in->data, *o = a->out;
+    size_t in_sz = in->len, out_sz = a->out_sz;
+
+    bench_sink += tiny_utf_convert(a->from, &i, &in_sz, a->to, &o, &out_sz);
+}
+
+static void do_utf_convert_parallel(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    void *i = in->data, *o = a->out;
+    size_t in_sz = in->len, out_sz = a->out_sz;
+
+    bench_sink += tiny_utf_convert_parallel(a->from, &i, &in_sz, a->to, &o, &out_sz, 0);
+}
+
+static void do_utf_detect(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    int conf;
+
+    bench_sink += tiny_utf_detect(in->data, in->len, &conf, NULL) + conf;
+}
+
+/* code points one at a time, as a tokenizer would */
+static void do_utf_iter(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    struct tiny_utf_iter it;
+    unsigned int cp, sum = 0;
+
+    tiny_utf_iter_init(&it, in->data, in->len);
+    switch(a->from)  {
+    case UTF_CODING_UTF8:
+        while(tiny_utf8_next(&it, &cp) > 0)
+            sum += cp;
+        break;
+    case UTF_CODING_UTF16BE:
+        while(tiny_utf16be_next(&it, &cp) > 0)
+            sum += cp;
+        break;
+    default:
+        while(tiny_utf16le_next(&it, &cp) > 0)
+            sum += cp;
+        break;
+    }
+    bench_sink += sum;
+}
+
+static void do_utf_iter_unchecked(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF8 ? &a->c->utf8
+        : a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    struct tiny_utf_iter it;
+    unsigned int sum = 0;
+
+    tiny_utf_iter_init(&it, in->data, in->len);
+    switch(a->from)  {
+    case UTF_CODING_UTF8:
+        while(tiny_utf_iter_left(&it))
+            sum += tiny_utf8_next_unchecked(&it);
+        break;
+    case UTF_CODING_UTF16BE:
+        while(tiny_utf_iter_left(&it))
+            sum += tiny_utf16be_next_unchecked(&it);
+        break;
+    default:
+        while(tiny_utf_iter_left(&it))
+            sum += tiny_utf16le_next_unchecked(&it);
+        break;
+    }
+    bench_sink += sum;
+}
+
+static void do_utf8_count(const struct bench_arg *a)
+{
+    bench_sink += tiny_utf8_count((const char *)a->c->utf8.data, a->c->utf8.len);
+}
+
+static void do_utf8_skip(const struct bench_arg *a)
+{
+    const struct buf *in = &a->c->utf8;
+
+    /* never past the end, no code point is longer than 4 bytes */
+    bench_sink += tiny_utf8_skip((const char *)in->data, in->len, in->len / 4);
+}
+
+static void do_utf8_index(const struct bench_arg *a)
+{
+    struct tiny_utf8_index *idx = tiny_utf8_index_new((const char *)a->c->utf8.data,
+                                                      a->c->utf8.len, 256);
+
+    bench_sink += idx->nr;
+    free(idx);
+}
+
+static void do_utf_to_utf8(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    char *s = tiny_utf_to_utf8((const char *)in->data, in->len, a->from);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_utf_to_utf8_preview(const struct bench_arg *a)
+{
+    const struct buf *in = a->from == UTF_CODING_UTF16BE ? &a->c->utf16be : &a->c->utf16le;
+    char *s = tiny_utf_to_utf8_range((const char *)in->data, in->len, a->from,
+                                     PREVIEW_CHARS, -1, NULL);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_gsm7(const struct bench_arg *a)
+{
+    char *s = tiny_decode_gsm7bit_packed_ex(a->c->gsm7.data, a->c->septets, 0,
+                                            a->single, a->locking);
+    bench_sink += s[0];
+    free(s);
+}
+
+/* inbox list preview, the first PREVIEW_CHARS characters only */
+static void do_gsm7_preview(const struct bench_arg *a)
+{
+    char *s = tiny_decode_gsm7bit_packed_range(a->c->gsm7.data, a->c->septets, 0, 0,
+                                               PREVIEW_CHARS, -1, a->single, a->locking, NULL);
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_gsm7_cached(const struct bench_arg *a)
+{
+    const char *s = tiny_decode_cache_gsm7bit_packed(a->cache, a->c->gsm7.data, a->c->septets, 0,
+                                                     a->single, a->locking);
+    bench_sink += s[0];
+    tiny_decode_cache_release(s);
+}
+
+static void do_cbs_page(const struct bench_arg *a)
+{
+    struct tiny_cbs_message *m = tiny_decode_cbs_page((const unsigned char *)a->out, CBS_PAGE_SIZE);
+
+    bench_sink += m->len;
+    free(m);
+}
+
+/* a page already seen, dropped by the seen set */
+static void do_cbs_repeat(const struct bench_arg *a)
+{
+    struct tiny_cbs_message *m;
+
+    bench_sink += tiny_cbs_assembler_feed(a->cbs, (const unsigned char *)a->out, CBS_PAGE_SIZE, &m);
+}
+
+static void do_gsm8(const struct bench_arg *a)
+{
+    char *s = tiny_decode_gsm8bit_unpacked_ex(a->c->gsm8.data, a->c->gsm8.len,
+                                              a->single, a->locking);
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_asc7bit_packed(const struct bench_arg *a)
+{
+    char *s = tiny_decode_asc7bit_packed(a->c->gsm7.data, a->c->septets, 0);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_asc7bit_unpacked(const struct bench_arg *a)
+{
+    char *s = tiny_decode_asc7bit_unpacked(a->c->gsm8.data, a->c->gsm8.len, 0);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_ucs16be(const struct bench_arg *a)
+{
+    char *s = tiny_decode_ucs16be(a->c->utf16be.data, a->c->utf16be.len);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_unicode(const struct bench_arg *a)
+{
+    char *s = tiny_decode_unicode(a->c->utf16be.data, a->c->utf16be.len / 2 - 1, 4);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_ucs2(const struct bench_arg *a)
+{
+    char *s = tiny_decode_ucs2((const char *)a->c->gsm8.data, 0x0400, a->c->gsm8.len);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static const unsigned char adn_81[] = {
+    0x81, 0x0C, 0x08, 0xAA, 0xAD, 0x20, 0x41, 0x9B, 0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0x30, 0x31,
+};
+
+static void do_adn(const struct bench_arg *a)
+{
+    char *s = tiny_decode_adn(adn_81, sizeof(adn_81));
+
+    bench_sink += s[0];
+    free(s);
+}
+
+#define ADN_RECLEN  28
+#define ADN_RECORDS 250
+
+static unsigned char adn_ef[ADN_RECLEN * ADN_RECORDS];
+
+static void do_adn_ef(const struct bench_arg *a)
+{
+    struct tiny_adn_record *recs;
+    int num;
+
+    recs = tiny_decode_adn_ef(adn_ef, sizeof(adn_ef), ADN_RECLEN, &num);
+    bench_sink += num;
+    free(recs);
+}
+
+static const unsigned char bcd_num[] = {
+    0x31, 0x08, 0x10, 0x32, 0x54, 0x76, 0x98, 0xF0,
+};
+
+static void do_bcd(const struct bench_arg *a)
+{
+    bench_sink += tiny_decode_bcd(0x21) + tiny_decode_bcd_cdma(0x12);
+}
+
+static void do_bcd_num(const struct bench_arg *a)
+{
+    unsigned char *s = tiny_decode_bcd_num(bcd_num, sizeof(bcd_num) * 2);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_bcd_num_cdma(const struct bench_arg *a)
+{
+    unsigned char *s = tiny_decode_bcd_num_cdma(bcd_num, sizeof(bcd_num) * 2 - 2, 4);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static const unsigned char ip_pdu[] = {
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+};
+
+static void do_ip_addr(const struct bench_arg *a)
+{
+    char *s = tiny_decode_ip_addr(ip_pdu, 3);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_ip_addr_r(const struct bench_arg *a)
+{
+    char buf[TINY_INET6_ADDRSTRLEN];
+
+    bench_sink += tiny_decode_ip_addr_r(ip_pdu, 0, a->from, buf, sizeof(buf), NULL);
+}
+
+static void do_hex_string(const struct bench_arg *a)
+{
+    int len;
+    char *s = tiny_decode_hex_string((const char *)a->out, &len);
+
+    bench_sink += len;
+    free(s);
+}
+
+static const char ussd_text[] = "Your balance is 12.50 EUR, valid until 31/12. Reply 1 for offers, 2 for data bundles, 0 to exit.";
+
+static void do_ussd_encode(const struct bench_arg *a)
+{
+    unsigned char pdu[160];
+
+    bench_sink += tiny_encode_ussd_r(ussd_text, sizeof(ussd_text) - 1, 0x0F, NULL, pdu, sizeof(pdu));
+}
+
+static void do_ussd_decode(const struct bench_arg *a)
+{
+    char buf[160 * 8 / 7 * 3 + 1];
+
+    bench_sink += tiny_decode_ussd_r((const unsigned char *)a->out, a->out_sz, 0x0F,
+                                     buf, sizeof(buf), NULL);
+}
+
+static const char sms_text[] = "Hi Ana, your order #4521 is on its way. Track it at example.com/t/4521 or reply STOP to opt out.";
+static const char sms_smart[] = "Hi Zoë, your “café crème” order #4521 is on its way — track it at example.com/t/4521…";
+
+static void do_gsm7_encode(const struct bench_arg *a)
+{
+    unsigned char pdu[160];
+
+    bench_sink += tiny_encode_gsm7bit_packed_r((const char *)a->out, a->out_sz, 0,
+                                               LANG_SHIFT_GSM7BIT, LANG_SHIFT_GSM7BIT,
+                                               a->from, pdu, sizeof(pdu));
+}
+
+static char trim_line[] = "  \t+CMGL: 1,\"REC UNREAD\",\"+8613800138000\",,\"18/11/11,10:00:00+32\"  \r\n";
+
+static void do_trim(const struct bench_arg *a)
+{
+    char *s = tiny_string_trim(trim_line, NULL, a->from);
+
+    bench_sink += s[0];
+    free(s);
+}
+
+static void do_trim_view(const struct bench_arg *a)
+{
+    size_t len;
+
+    bench_sink += (unsigned long)tiny_string_trim_view(trim_line, NULL, &len) + len;
+}
+
+static void do_list_split(const struct bench_arg *a)
+{
+    int cnt;
+    char **arr = tiny_string_list_split(a->c->list, NULL, &cnt);
+
+    bench_sink += cnt;
+    free(arr);
+}
+
+static void do_list_iter(const struct bench_arg *a)
+{
+    struct tiny_string_list_iter iter;
+    size_t len;
+
+    tiny_string_list_iter_init(&iter, a->c->list, NULL);
+    while(tiny_string_list_iter_next(&iter, &len))
+        bench_sink += len;
+}
+
+static void do_list_find(const struct bench_arg *a)
+{
+    /* miss, the worst case scan */
+    bench_sink += tiny_string_list_find(a->c->list, NULL, "13800000000");
+}
+
+static void do_list_update(const struct bench_arg *a)
+{
+    tiny_string_list_insert(a->out, NULL, a->out_sz, "13800000000");
+    tiny_string_list_remove(a->out, NULL, "13800000000");
+}
+
+static void do_list_concat(const struct bench_arg *a)
+{
+    ((char *)a->out)[0] = '\0';
+    bench_sink += tiny_string_list_concat(a->out, NULL, a->out_sz, a->c->list);
+}
+
+static void do_set_new(const struct bench_arg *a)
+{
+    tiny_string_set *set = tiny_string_set_new(a->c->list, NULL);
+
+    bench_sink += tiny_string_set_count(set);
+    tiny_string_set_free(set);
+}
+
+static void do_set_find(const struct bench_arg *a)
+{
+    bench_sink += tiny_string_set_find(a->out, "13800000000");
+}
+
+static void do_set_update(const struct bench_arg *a)
+{
+    tiny_string_set_insert(a->out, "13800000000");
+    tiny_string_set_remove(a->out, "13800000000");
+}
+
+static void do_set_serialize(const struct bench_arg *a)
+{
+    bench_sink += tiny_string_set_serialize(a->out, NULL, (char *)a->c->utf8.data, a->c->utf8.len);
+}
+
+static const char *utf_name(int coding)
+{
+    return coding == UTF_CODING_UTF8 ? UTF_CODING_UTF8_NAME
+        : coding == UTF_CODING_UTF16BE ? UTF_CODING_UTF16BE_NAME
+        : coding == UTF_CODING_UTF16LE ? UTF_CODING_UTF16LE_NAME
+        : coding == UTF_CODING_LATIN1 ? UTF_CODING_LATIN1_NAME : UTF_CODING_CP1252_NAME;
+}
+
+static size_t utf_len(const struct corpus *c, int coding)
+{
+    return coding == UTF_CODING_UTF8 ? c->utf8.len
+        : coding == UTF_CODING_UTF16BE ? c->utf16be.len
+        : coding == UTF_CODING_UTF16LE ? c->utf16le.len : c->latin1.len;
+}
+
+static void bench_text(struct corpus *c)
+{
+    static const int pairs[][2] = {
+        {UTF_CODING_UTF8, UTF_CODING_UTF16BE},
+        {UTF_CODING_UTF8, UTF_CODING_UTF16LE},
+        {UTF_CODING_UTF16BE, UTF_CODING_UTF8},
+        {UTF_CODING_UTF16LE, UTF_CODING_UTF8},
+        {UTF_CODING_UTF16BE, UTF_CODING_UTF16LE},
+        {UTF_CODING_UTF16LE, UTF_CODING_UTF16BE},
+    };
+    static const int sbcs_pairs[][2] = {
+        {UTF_CODING_LATIN1, UTF_CODING_UTF8},
+        {UTF_CODING_LATIN1, UTF_CODING_UTF16LE},
+        {UTF_CODING_CP1252, UTF_CODING_UTF8},
+        {UTF_CODING_UTF8, UTF_CODING_LATIN1},
+        {UTF_CODING_UTF16LE, UTF_CODING_LATIN1},
+        {UTF_CODING_UTF8, UTF_CODING_CP1252},
+    };
+    struct bench_arg a = {c};
+    char name[64];
+    unsigned int i;
+
+    a.out_sz = c->utf8.len * 2 + c->utf16be.len * 2 + 16;
+    a.out = malloc(a.out_sz);
+    if(! a.out)
+        return;
+
+    for(i = 0; i < ARRAYSIZE(pairs); i++)  {
+        a.from = pairs[i][0];
+        a.to = pairs[i][1];
+        snprintf(name, sizeof(name), "utf_convert:%s>%s", utf_name(a.from), utf_name(a.to));
+        bench_run(name, c->name, utf_len(c, a.from), do_utf_convert, &a);
+        snprintf(name, sizeof(name), "utf_convert_replace:%s>%s", utf_name(a.from), utf_name(a.to));
+        bench_run(name, c->name, utf_len(c, a.from), do_utf_convert_replace, &a);
+    }
+
+    for(i = 0; c->latin1.len && i < ARRAYSIZE(sbcs_pairs); i++)  {
+        a.from = sbcs_pairs[i][0];
+        a.to = sbcs_pairs[i][1];
+        snprintf(name, sizeof(name), "utf_convert:%s>%s", utf_name(a.from), utf_name(a.to));
+        bench_run(name, c->name, utf_len(c, a.from), do_sbcs_convert, &a);
+    }
+
+    /* only large buffers are worth splitting */
+    if(c->utf8.len >= 1024 * 1024)  {
+        for(i = 0; i < ARRAYSIZE(pairs); i++)  {
+            a.from = pairs[i][0];
+            a.to = pairs[i][1];
+            snprintf(name, sizeof(name), "utf_convert_parallel:%s>%s", utf_name(a.from), utf_name(a.to));
+            bench_run(name, c->name, utf_len(c, a.from), do_utf_convert_parallel, &a);
+        }
+    }
+
+    bench_run("utf8_count", c->name, c->utf8.len, do_utf8_count, &a);
+    bench_run("utf8_skip", c->name, c->utf8.len, do_utf8_skip, &a);
+    bench_run("utf8_index_new", c->name, c->utf8.len, do_utf8_index, &a);
+
+    for(i = UTF_CODING_UTF8; i <= UTF_CODING_UTF16LE; i++)  {
+        a.from = i;
+        snprintf(name, sizeof(name), "utf_detect:%s", utf_name(a.from));
+        bench_run(name, c->name, utf_len(c, a.from), do_utf_detect, &a);
+        snprintf(name, sizeof(name), "utf_iter:%s", utf_name(a.from));
+        bench_run(name, c->name, utf_len(c, a.from), do_utf_iter, &a);
+        snprintf(name, sizeof(name), "utf_iter_unchecked:%s", utf_name(a.from));
+        bench_run(name, c->name, utf_len(c, a.from), do_utf_iter_unchecked, &a);
+    }
+
+    a.from = UTF_CODING_UTF16BE;
+    bench_run("utf_to_utf8:UTF16BE", c->name, c->utf16be.len, do_utf_to_utf8, &a);
+    a.from = UTF_CODING_UTF16LE;
+    bench_run("utf_to_utf8:UTF16LE", c->name, c->utf16le.len, do_utf_to_utf8, &a);
+    bench_run("utf_to_utf8_preview:UTF16LE", c->name, c->utf16le.len, do_utf_to_utf8_preview, &a);
+    bench_run("decode_ucs16be", c->name, c->utf16be.len, do_ucs16be, &a);
+    if(c->utf16be.len > 4)
+        bench_run("decode_unicode", c->name, c->utf16be.len, do_unicode, &a);
+
+    free(a.out);
+}
+
+static void bench_gsm(struct corpus *c)
+{
+    static const int langs[] = {
+        LANG_SHIFT_GSM7BIT, LANG_SHIFT_TURKISH, LANG_SHIFT_SPANISH, LANG_SHIFT_PORTUGUESE,
+        LANG_SHIFT_HINDI, LANG_SHIFT_URDU,
+    };
+    struct bench_arg a = {c};
+    char name[64];
+    unsigned int i;
+
+    a.cache = tiny_decode_cache_new(1024);
+    for(i = 0; i < ARRAYSIZE(langs); i++)  {
+        a.single = a.locking = langs[i];
+        snprintf(name, sizeof(name), "gsm7bit_packed:%d", langs[i]);
+        bench_run(name, c->name, c->gsm7.len, do_gsm7, &a);
+        if(a.cache)  {
+            snprintf(name, sizeof(name), "gsm7bit_packed_cached:%d", langs[i]);
+            bench_run(name, c->name, c->gsm7.len, do_gsm7_cached, &a);
+        }
+        snprintf(name, sizeof(name), "gsm7bit_packed_preview:%d", langs[i]);
+        bench_run(name, c->name, c->gsm7.len, do_gsm7_preview, &a);
+        snprintf(name, sizeof(name), "gsm8bit_unpacked:%d", langs[i]);
+        bench_run(name, c->name, c->gsm8.len, do_gsm8, &a);
+    }
+
+    bench_run("asc7bit_packed", c->name, c->gsm7.len, do_asc7bit_packed, &a);
+    bench_run("asc7bit_unpacked", c->name, c->gsm8.len, do_asc7bit_unpacked, &a);
+    bench_run("decode_ucs2", c->name, c->gsm8.len, do_ucs2, &a);
+    tiny_decode_cache_free(a.cache);
+
+    /* the corpus as a single CBS page, english default alphabet */
+    if(c->gsm7.len >= CBS_CONTENT_SIZE && (a.out = calloc(1, CBS_PAGE_SIZE)))  {
+        static const unsigned char hdr[] = {0x12, 0x34, 0x11, 0x12, 0x01, 0x11};
+        struct tiny_cbs_message *m;
+
+        memcpy(a.out, hdr, sizeof(hdr));
+        memcpy((char *)a.out + sizeof(hdr), c->gsm7.data, CBS_CONTENT_SIZE);
+        bench_run("cbs_page", c->name, CBS_PAGE_SIZE, do_cbs_page, &a);
+        if((a.cbs = tiny_cbs_assembler_new(1024)))  {
+            tiny_cbs_assembler_feed(a.cbs, (const unsigned char *)a.out, CBS_PAGE_SIZE, &m);
+            free(m);
+            bench_run("cbs_repeat", c->name, CBS_PAGE_SIZE, do_cbs_repeat, &a);
+            tiny_cbs_assembler_free(a.cbs);
+        }
+        free(a.out);
+    }
+}
+
+static void bench_list(struct corpus *c)
+{
+    struct bench_arg a = {c};
+    size_t len = strlen(c->list);
+    tiny_string_set *set;
+
+    bench_run("list_split", c->name, len, do_list_split, &a);
+    bench_run("list_iter", c->name, len, do_list_iter, &a);
+    bench_run("list_find", c->name, len, do_list_find, &a);
+
+    a.out_sz = len * 2 + 32;
+    if((a.out = malloc(a.out_sz)))  {
+        strcpy(a.out, c->list);
+        bench_run("list_insert_remove", c->name, len, do_list_update, &a);
+        /* quadratic, keep it to the smaller lists */
+        if(len < 16 * 1024)
+            bench_run("list_concat", c->name, len, do_list_concat, &a);
+        free(a.out);
+    }
+
+    bench_run("set_new", c->name, len, do_set_new, &a);
+    if((set = tiny_string_set_new(c->list, NULL)))  {
+        a.out = set;
+        bench_run("set_find", c->name, 0, do_set_find, &a);
+        bench_run("set_insert_remove", c->name, 0, do_set_update, &a);
+        if(c->utf8.len > len)
+            bench_run("set_serialize", c->name, len, do_set_serialize, &a);
+        tiny_string_set_free(set);
+    }
+}
+
+static void bench_misc(void)
+{
+    struct bench_arg a = {NULL};
+    static const char hex[] = "0891683108200805F0240BA13108101325F40000811011";
+    int i;
+
+    for(i = 0; i < ADN_RECORDS; i++)  {
+        memset(adn_ef + i * ADN_RECLEN, 0xFF, ADN_RECLEN);
+        memcpy(adn_ef + i * ADN_RECLEN, (i & 1) ? "Contact" : (const char *)adn_81,
+               (i & 1) ? 7 : sizeof(adn_81));
+        memcpy(adn_ef + i * ADN_RECLEN + ADN_RECLEN - 14, "\x06\x91\x31\x42\x65\x87\xF9", 7);
+    }
+
+    bench_run("decode_adn", "adn81", sizeof(adn_81), do_adn, &a);
+    bench_run("decode_adn_ef", "ef250", sizeof(adn_ef), do_adn_ef, &a);
+    bench_run("decode_bcd", "octet", 2, do_bcd, &a);
+    bench_run("decode_bcd_num", "num16", sizeof(bcd_num), do_bcd_num, &a);
+    bench_run("decode_bcd_num_cdma", "num14", sizeof(bcd_num) - 1, do_bcd_num_cdma, &a);
+    bench_run("decode_ip_addr", "ipv4", 4, do_ip_addr, &a);
+    a.from = TINY_IPV4_ADDR_LEN;
+    bench_run("decode_ip_addr_r:4", "ipv4", 4, do_ip_addr_r, &a);
+    a.from = TINY_IPV6_ADDR_LEN;
+    bench_run("decode_ip_addr_r:16", "ipv6", 16, do_ip_addr_r, &a);
+    a.out = (void *)hex;
+    bench_run("decode_hex_string", "pdu", sizeof(hex) - 1, do_hex_string, &a);
+
+    a.out = (void *)sms_text;
+    a.out_sz = sizeof(sms_text) - 1;
+    a.from = 0;
+    bench_run("gsm7bit_encode", "sms", a.out_sz, do_gsm7_encode, &a);
+    a.from = GSM_ENC_TRANSLIT;
+    bench_run("gsm7bit_encode:translit", "sms", a.out_sz, do_gsm7_encode, &a);
+    a.out = (void *)sms_smart;
+    a.out_sz = sizeof(sms_smart) - 1;
+    bench_run("gsm7bit_encode:translit", "sms_smart", a.out_sz, do_gsm7_encode, &a);
+
+    bench_run("ussd_encode", "ussd", sizeof(ussd_text) - 1, do_ussd_encode, &a);
+    if((a.out = malloc(160)))  {
+        a.out_sz = tiny_encode_ussd_r(ussd_text, sizeof(ussd_text) - 1, 0x0F, NULL,
+                                      (unsigned char *)a.out, 160);
+        bench_run("ussd_decode", "ussd", a.out_sz, do_ussd_decode, &a);
+        free(a.out);
+    }
+
+    a.from = TRIM_ALL;
+    bench_run("string_trim:all", "atline", sizeof(trim_line) - 1, do_trim, &a);
+    a.from = TRIM_FRONT | TRIM_END;
+    bench_run("string_trim:front_end", "atline", sizeof(trim_line) - 1, do_trim, &a);
+    bench_run("string_trim_view", "atline", sizeof(trim_line) - 1, do_trim_view, &a);
+}
+
+static void corpus_free(struct corpus *c)
+{
+    free(c->utf8.data);
+    free(c->utf16be.data);
+    free(c->utf16le.data);
+    free(c->latin1.data);
+    free(c->gsm7.data);
+    free(c->gsm8.data);
+    free(c->list);
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct {
+        const char *name;
+        unsigned int (*script)(unsigned int);
+    } scripts[] = {
+        {"ascii", script_ascii},
+        {"latin", script_latin},
+        {"cjk", script_cjk},
+        {"emoji", script_emoji},
+    };
+    static const size_t text_sizes[] = {64, 4096, 1 << 20};
+    static const int gsm_sizes[] = {160, 1530, 65536};
+    static const int list_sizes[] = {16, 1000, 20000};
+    struct corpus c;
+    char name[64];
+    unsigned int i, j;
+
+    for(i = 1; i < argc; i++)  {
+        if(! strcmp(argv[i], "-t") && i + 1 < argc)
+            bench_ns = strtoul(argv[++i], NULL, 10) * 1000000UL;
+        else if(! strcmp(argv[i], "-f") && i + 1 < argc)
+            bench_filter = argv[++i];
+        else if(! (bench_out = fopen(argv[i], "w")))
+            printf("unable to open \"%s\"!\n", argv[i]);
+    }
+
+    printf("name,corpus,bytes,iterations,ns_per_call,mb_per_s\n");
+    if(bench_out)
+        fprintf(bench_out, "name,corpus,bytes,iterations,ns_per_call,mb_per_s\n");
+
+    memset(&c, 0, sizeof(c));
+    c.name = "test.utf";
+    if(! load_file(&c.utf8, "test.utf8") && ! load_file(&c.utf16be, "test.utf16be") &&
+       ! load_file(&c.utf16le, "test.utf16le"))
+        bench_text(&c);
+    corpus_free(&c);
+
+    for(i = 0; i < ARRAYSIZE(scripts); i++)  {
+        for(j = 0; j < ARRAYSIZE(text_sizes); j++)  {
+            memset(&c, 0, sizeof(c));
+            snprintf(name, sizeof(name), "%s-%zu", scripts[i].name, text_sizes[j]);
+            c.name = name;
+            gen_text(&c, scripts[i].script, text_sizes[j]);
+            bench_text(&c);
+            corpus_free(&c);
+        }
+    }
+
+    for(i = 0; i < ARRAYSIZE(gsm_sizes); i++)  {
+        memset(&c, 0, sizeof(c));
+        snprintf(name, sizeof(name), "gsm-%d", gsm_sizes[i]);
+        c.name = name;
+        gen_gsm(&c, gsm_sizes[i]);
+        bench_gsm(&c);
+        corpus_free(&c);
+    }
+
+    for(i = 0; i < ARRAYSIZE(list_sizes); i++)  {
+        memset(&c, 0, sizeof(c));
+        snprintf(name, sizeof(name), "list-%d", list_sizes[i]);
+        c.name = name;
+        gen_list(&c, list_sizes[i]);
+        /* scratch buffer for serializing */
+        c.utf8.len = strlen(c.list) + 1;
+        c.utf8.data = (unsigned char *)malloc(c.utf8.len);
+        bench_list(&c);
+        corpus_free(&c);
+    }
+
+    bench_misc();
+
+    if(bench_out)
+        fclose(bench_out);
+    return 0;
+}
@@ -0,0 +1,588 @@
+/*
+ * UTF/GSM/CDMA encoding conversion utils.
+ * Copyright (C) <2018>  Crs Chin<crs.chin@gmail.com>
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * GSM 7 bit tables, data only, shared by tinycode.c and tinycode.hpp.
+ * the includer defines GSM_TABLES_STORAGE, "static const" in C and
+ * "inline constexpr" in C++, and includes it once.
+ */
+#ifndef GSM_TABLES_STORAGE
+ #error "define GSM_TABLES_STORAGE before including gsm_tables.h"
+#endif
+
+/*
+ * GSM 7 bit default alphabet and the TS 23.038 annex A national
+ * language single/locking shift tables, each septet held as UTF-8 in 4
+ * bytes so decoding is one fixed size copy whatever the language.
+ * escape and undefined septets carry GSM_CHAR_UNDEF and decode to a
+ * space. the page break of single shift tables decodes as a newline.
+ */
+struct gsm_char {
+    unsigned char utf8[3];
+    unsigned char len;
+};
+
+#define GSM_CHAR_UNDEF  0x80
+
+/* @cp below 0x10000 as a gsm_char, at compile time */
+#define G(cp)                                                           \
+    {{(cp) < 0x80 ? (cp) : (cp) < 0x800 ? 0xC0 | (cp) >> 6 : 0xE0 | (cp) >> 12, \
+      (cp) < 0x80 ? 0 : (cp) < 0x800 ? 0x80 | ((cp) & 0x3F) : 0x80 | (((cp) >> 6) & 0x3F), \
+      (cp) < 0x800 ? 0 : 0x80 | ((cp) & 0x3F)},                        \
+     (cp) < 0x80 ? 1 : (cp) < 0x800 ? 2 : 3}
+#define G_      {{' ', 0, 0}, 1 | GSM_CHAR_UNDEF}
+
+#define GSM_TBL_DEFAULT         0
+#define GSM_TBL_DEFAULT_EX      1
+#define GSM_TBL_TURKISH_S       2
+#define GSM_TBL_TURKISH_L       3
+#define GSM_TBL_SPANISH_S       4
+#define GSM_TBL_PORTUGUESE_S    5
+#define GSM_TBL_PORTUGUESE_L    6
+#define GSM_TBL_BENGALI_S       7
+#define GSM_TBL_BENGALI_L       8
+#define GSM_TBL_GUJARATI_S      9
+#define GSM_TBL_GUJARATI_L      10
+#define GSM_TBL_HINDI_S         11
+#define GSM_TBL_HINDI_L         12
+#define GSM_TBL_KANNADA_S       13
+#define GSM_TBL_KANNADA_L       14
+#define GSM_TBL_MALAYALAM_S     15
+#define GSM_TBL_MALAYALAM_L     16
+#define GSM_TBL_ORIYA_S         17
+#define GSM_TBL_ORIYA_L         18
+#define GSM_TBL_PUNJABI_S       19
+#define GSM_TBL_PUNJABI_L       20
+#define GSM_TBL_TAMIL_S         21
+#define GSM_TBL_TAMIL_L         22
+#define GSM_TBL_TELUGU_S        23
+#define GSM_TBL_TELUGU_L        24
+#define GSM_TBL_URDU_S          25
+#define GSM_TBL_URDU_L          26
+#define GSM_TBL_MAX             27
+
+GSM_TABLES_STORAGE struct gsm_char gsm_tables[GSM_TBL_MAX][128] = {
+    /* GSM_TBL_DEFAULT */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00E8), G(0x00E9), G(0x00F9), G(0x00EC),  /* 0x00 */
+        G(0x00F2), G(0x00C7), G(0x000A), G(0x00D8), G(0x00F8), G(0x000D), G(0x00C5), G(0x00E5),  /* 0x08 */
+        G(0x0394), G(0x005F), G(0x03A6), G(0x0393), G(0x039B), G(0x03A9), G(0x03A0), G(0x03A8),  /* 0x10 */
+        G(0x03A3), G(0x0398), G(0x039E), G_, G(0x00C6), G(0x00E6), G(0x00DF), G(0x00C9),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0022), G(0x0023), G(0x00A4), G(0x0025), G(0x0026), G(0x0027),  /* 0x20 */
+        G(0x0028), G(0x0029), G(0x002A), G(0x002B), G(0x002C), G(0x002D), G(0x002E), G(0x002F),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G(0x003C), G(0x003D), G(0x003E), G(0x003F),  /* 0x38 */
+        G(0x00A1), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G(0x00C4), G(0x00D6), G(0x00D1), G(0x00DC), G(0x00A7),  /* 0x58 */
+        G(0x00BF), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x00E4), G(0x00F6), G(0x00F1), G(0x00FC), G(0x00E0),  /* 0x78 */
+    },
+    /* GSM_TBL_DEFAULT_EX */ {
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x00 */
+        G_, G_, G(0x000A), G_, G_, G_, G_, G_,                                                   /* 0x08 */
+        G_, G_, G_, G_, G(0x005E), G_, G_, G_,                                                   /* 0x10 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x18 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x20 */
+        G(0x007B), G(0x007D), G_, G_, G_, G_, G_, G(0x005C),                                     /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G_, G_, G_, G_, G_, G_, G_,                                                   /* 0x40 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x48 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x50 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_TURKISH_S */ {
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x00 */
+        G_, G_, G(0x000A), G_, G_, G_, G_, G_,                                                   /* 0x08 */
+        G_, G_, G_, G_, G(0x005E), G_, G_, G_,                                                   /* 0x10 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x18 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x20 */
+        G(0x007B), G(0x007D), G_, G_, G_, G_, G_, G(0x005C),                                     /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G_, G_, G_, G_, G_, G_, G(0x011E),                                            /* 0x40 */
+        G_, G(0x0130), G_, G_, G_, G_, G_, G_,                                                   /* 0x48 */
+        G_, G_, G_, G(0x015E), G_, G_, G_, G_,                                                   /* 0x50 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x58 */
+        G_, G_, G_, G(0x00E7), G_, G(0x20AC), G_, G(0x011F),                                     /* 0x60 */
+        G_, G(0x0131), G_, G_, G_, G_, G_, G_,                                                   /* 0x68 */
+        G_, G_, G_, G(0x015F), G_, G_, G_, G_,                                                   /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_TURKISH_L */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x20AC), G(0x00E9), G(0x00F9), G(0x0131),  /* 0x00 */
+        G(0x00F2), G(0x00C7), G(0x000A), G(0x011E), G(0x011F), G(0x000D), G(0x00C5), G(0x00E5),  /* 0x08 */
+        G(0x0394), G(0x005F), G(0x03A6), G(0x0393), G(0x039B), G(0x03A9), G(0x03A0), G(0x03A8),  /* 0x10 */
+        G(0x03A3), G(0x0398), G(0x039E), G_, G(0x015E), G(0x015F), G(0x00DF), G(0x00C9),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0022), G(0x0023), G(0x00A4), G(0x0025), G(0x0026), G(0x0027),  /* 0x20 */
+        G(0x0028), G(0x0029), G(0x002A), G(0x002B), G(0x002C), G(0x002D), G(0x002E), G(0x002F),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G(0x003C), G(0x003D), G(0x003E), G(0x003F),  /* 0x38 */
+        G(0x0130), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G(0x00C4), G(0x00D6), G(0x00D1), G(0x00DC), G(0x00A7),  /* 0x58 */
+        G(0x00E7), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x00E4), G(0x00F6), G(0x00F1), G(0x00FC), G(0x00E0),  /* 0x78 */
+    },
+    /* GSM_TBL_SPANISH_S */ {
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x00 */
+        G_, G(0x00E7), G(0x000A), G_, G_, G_, G_, G_,                                            /* 0x08 */
+        G_, G_, G_, G_, G(0x005E), G_, G_, G_,                                                   /* 0x10 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x18 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x20 */
+        G(0x007B), G(0x007D), G_, G_, G_, G_, G_, G(0x005C),                                     /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x00C1), G_, G_, G_, G_, G_, G_,                                            /* 0x40 */
+        G_, G(0x00CD), G_, G_, G_, G_, G_, G(0x00D3),                                            /* 0x48 */
+        G_, G_, G_, G_, G_, G(0x00DA), G_, G_,                                                   /* 0x50 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x58 */
+        G_, G(0x00E1), G_, G_, G_, G(0x20AC), G_, G_,                                            /* 0x60 */
+        G_, G(0x00ED), G_, G_, G_, G_, G_, G(0x00F3),                                            /* 0x68 */
+        G_, G_, G_, G_, G_, G(0x00FA), G_, G_,                                                   /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_PORTUGUESE_S */ {
+        G_, G_, G_, G_, G_, G(0x00EA), G_, G_,                                                   /* 0x00 */
+        G_, G(0x00E7), G(0x000A), G(0x00D4), G(0x00F4), G_, G(0x00C1), G(0x00E1),                /* 0x08 */
+        G_, G_, G(0x03A6), G(0x0393), G(0x005E), G(0x03A9), G(0x03A0), G(0x03A8),                /* 0x10 */
+        G(0x03A3), G(0x0398), G_, G_, G_, G_, G_, G(0x00CA),                                     /* 0x18 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x20 */
+        G(0x007B), G(0x007D), G_, G_, G_, G_, G_, G(0x005C),                                     /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x00C0), G_, G_, G_, G_, G_, G_,                                            /* 0x40 */
+        G_, G(0x00CD), G_, G_, G_, G_, G_, G(0x00D3),                                            /* 0x48 */
+        G_, G_, G_, G_, G_, G(0x00DA), G_, G_,                                                   /* 0x50 */
+        G_, G_, G_, G(0x00C3), G(0x00D5), G_, G_, G_,                                            /* 0x58 */
+        G_, G(0x00C2), G_, G_, G_, G(0x20AC), G_, G_,                                            /* 0x60 */
+        G_, G(0x00ED), G_, G_, G_, G_, G_, G(0x00F3),                                            /* 0x68 */
+        G_, G_, G_, G_, G_, G(0x00FA), G_, G_,                                                   /* 0x70 */
+        G_, G_, G_, G(0x00E3), G(0x00F5), G_, G_, G(0x00E2),                                     /* 0x78 */
+    },
+    /* GSM_TBL_PORTUGUESE_L */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00EA), G(0x00E9), G(0x00FA), G(0x00ED),  /* 0x00 */
+        G(0x00F3), G(0x00E7), G(0x000A), G(0x00D4), G(0x00F4), G(0x000D), G(0x00C1), G(0x00E1),  /* 0x08 */
+        G(0x0394), G(0x005F), G(0x00AA), G(0x00C7), G(0x00C0), G(0x221E), G(0x005E), G(0x005C),  /* 0x10 */
+        G(0x20AC), G(0x00D3), G(0x007C), G_, G(0x00C2), G(0x00E2), G(0x00CA), G(0x00C9),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0022), G(0x0023), G(0x00BA), G(0x0025), G(0x0026), G(0x0027),  /* 0x20 */
+        G(0x0028), G(0x0029), G(0x002A), G(0x002B), G(0x002C), G(0x002D), G(0x002E), G(0x002F),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G(0x003C), G(0x003D), G(0x003E), G(0x003F),  /* 0x38 */
+        G(0x00CD), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G(0x00C3), G(0x00D5), G(0x00DA), G(0x00DC), G(0x00A7),  /* 0x58 */
+        G(0x007E), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x00E3), G(0x00F5), G(0x0060), G(0x00FC), G(0x00E0),  /* 0x78 */
+    },
+    /* GSM_TBL_BENGALI_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x09E6), G(0x09E7), G_, G(0x09E8), G(0x09E9), G(0x09EA), G(0x09EB),         /* 0x18 */
+        G(0x09EC), G(0x09ED), G(0x09EE), G(0x09EF), G(0x09DF), G(0x09E0), G(0x09E1), G(0x09E2),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x09E3), G(0x09F2), G(0x09F3), G(0x09F4), G(0x09F5), G(0x005C),  /* 0x28 */
+        G(0x09F6), G(0x09F7), G(0x09F8), G(0x09F9), G(0x09FA), G_, G_, G_,                       /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_BENGALI_L */ {
+        G(0x0981), G(0x0982), G(0x0983), G(0x0985), G(0x0986), G(0x0987), G(0x0988), G(0x0989),  /* 0x00 */
+        G(0x098A), G(0x098B), G(0x000A), G(0x098C), G_, G(0x000D), G_, G(0x098F),                /* 0x08 */
+        G(0x0990), G_, G_, G(0x0993), G(0x0994), G(0x0995), G(0x0996), G(0x0997),                /* 0x10 */
+        G(0x0998), G(0x0999), G(0x099A), G_, G(0x099B), G(0x099C), G(0x099D), G(0x099E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x099F), G(0x09A0), G(0x09A1), G(0x09A2), G(0x09A3), G(0x09A4),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x09A5), G(0x09A6), G(0x002C), G(0x09A7), G(0x002E), G(0x09A8),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x09AA), G(0x09AB), G(0x003F),         /* 0x38 */
+        G(0x09AC), G(0x09AD), G(0x09AE), G(0x09AF), G(0x09B0), G_, G(0x09B2), G_,                /* 0x40 */
+        G_, G_, G(0x09B6), G(0x09B7), G(0x09B8), G(0x09B9), G(0x09BC), G(0x09BD),                /* 0x48 */
+        G(0x09BE), G(0x09BF), G(0x09C0), G(0x09C1), G(0x09C2), G(0x09C3), G(0x09C4), G_,         /* 0x50 */
+        G_, G(0x09C7), G(0x09C8), G_, G_, G(0x09CB), G(0x09CC), G(0x09CD),                       /* 0x58 */
+        G(0x09CE), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x09D7), G(0x09DC), G(0x09DD), G(0x09F0), G(0x09F1),  /* 0x78 */
+    },
+    /* GSM_TBL_GUJARATI_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0AE6), G(0x0AE7), G(0x0AE8), G(0x0AE9),         /* 0x18 */
+        G(0x0AEA), G(0x0AEB), G(0x0AEC), G(0x0AED), G(0x0AEE), G(0x0AEF), G_, G_,                /* 0x20 */
+        G(0x007B), G(0x007D), G_, G_, G_, G_, G_, G(0x005C),                                     /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_GUJARATI_L */ {
+        G(0x0A81), G(0x0A82), G(0x0A83), G(0x0A85), G(0x0A86), G(0x0A87), G(0x0A88), G(0x0A89),  /* 0x00 */
+        G(0x0A8A), G(0x0A8B), G(0x000A), G(0x0A8C), G(0x0A8D), G(0x000D), G_, G(0x0A8F),         /* 0x08 */
+        G(0x0A90), G(0x0A91), G_, G(0x0A93), G(0x0A94), G(0x0A95), G(0x0A96), G(0x0A97),         /* 0x10 */
+        G(0x0A98), G(0x0A99), G(0x0A9A), G_, G(0x0A9B), G(0x0A9C), G(0x0A9D), G(0x0A9E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0A9F), G(0x0AA0), G(0x0AA1), G(0x0AA2), G(0x0AA3), G(0x0AA4),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0AA5), G(0x0AA6), G(0x002C), G(0x0AA7), G(0x002E), G(0x0AA8),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x0AAA), G(0x0AAB), G(0x003F),         /* 0x38 */
+        G(0x0AAC), G(0x0AAD), G(0x0AAE), G(0x0AAF), G(0x0AB0), G_, G(0x0AB2), G(0x0AB3),         /* 0x40 */
+        G_, G(0x0AB5), G(0x0AB6), G(0x0AB7), G(0x0AB8), G(0x0AB9), G(0x0ABC), G(0x0ABD),         /* 0x48 */
+        G(0x0ABE), G(0x0ABF), G(0x0AC0), G(0x0AC1), G(0x0AC2), G(0x0AC3), G(0x0AC4), G(0x0AC5),  /* 0x50 */
+        G_, G(0x0AC7), G(0x0AC8), G(0x0AC9), G_, G(0x0ACB), G(0x0ACC), G(0x0ACD),                /* 0x58 */
+        G(0x0AD0), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0AE0), G(0x0AE1), G(0x0AE2), G(0x0AE3), G(0x0AF1),  /* 0x78 */
+    },
+    /* GSM_TBL_HINDI_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0966), G(0x0967), G(0x0968), G(0x0969),         /* 0x18 */
+        G(0x096A), G(0x096B), G(0x096C), G(0x096D), G(0x096E), G(0x096F), G(0x0951), G(0x0952),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0953), G(0x0954), G(0x0958), G(0x0959), G(0x095A), G(0x005C),  /* 0x28 */
+        G(0x095B), G(0x095C), G(0x095D), G(0x095E), G(0x095F), G(0x0960), G(0x0961), G(0x0962),  /* 0x30 */
+        G(0x0963), G(0x0970), G(0x0971), G_, G(0x005B), G(0x007E), G(0x005D), G_,                /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_HINDI_L */ {
+        G(0x0901), G(0x0902), G(0x0903), G(0x0905), G(0x0906), G(0x0907), G(0x0908), G(0x0909),  /* 0x00 */
+        G(0x090A), G(0x090B), G(0x000A), G(0x090C), G(0x090D), G(0x000D), G(0x090E), G(0x090F),  /* 0x08 */
+        G(0x0910), G(0x0911), G(0x0912), G(0x0913), G(0x0914), G(0x0915), G(0x0916), G(0x0917),  /* 0x10 */
+        G(0x0918), G(0x0919), G(0x091A), G_, G(0x091B), G(0x091C), G(0x091D), G(0x091E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x091F), G(0x0920), G(0x0921), G(0x0922), G(0x0923), G(0x0924),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0925), G(0x0926), G(0x002C), G(0x0927), G(0x002E), G(0x0928),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G(0x0929), G(0x092A), G(0x092B), G(0x003F),  /* 0x38 */
+        G(0x092C), G(0x092D), G(0x092E), G(0x092F), G(0x0930), G(0x0931), G(0x0932), G(0x0933),  /* 0x40 */
+        G(0x0934), G(0x0935), G(0x0936), G(0x0937), G(0x0938), G(0x0939), G(0x093C), G(0x093D),  /* 0x48 */
+        G(0x093E), G(0x093F), G(0x0940), G(0x0941), G(0x0942), G(0x0943), G(0x0944), G(0x0945),  /* 0x50 */
+        G(0x0946), G(0x0947), G(0x0948), G(0x0949), G(0x094A), G(0x094B), G(0x094C), G(0x094D),  /* 0x58 */
+        G(0x0950), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0972), G(0x097B), G(0x097C), G(0x097E), G(0x097F),  /* 0x78 */
+    },
+    /* GSM_TBL_KANNADA_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0CE6), G(0x0CE7), G(0x0CE8), G(0x0CE9),         /* 0x18 */
+        G(0x0CEA), G(0x0CEB), G(0x0CEC), G(0x0CED), G(0x0CEE), G(0x0CEF), G(0x0CDE), G(0x0CF1),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0CF2), G_, G_, G_, G_, G(0x005C),                              /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_KANNADA_L */ {
+        G_, G(0x0C82), G(0x0C83), G(0x0C85), G(0x0C86), G(0x0C87), G(0x0C88), G(0x0C89),         /* 0x00 */
+        G(0x0C8A), G(0x0C8B), G(0x000A), G(0x0C8C), G_, G(0x000D), G(0x0C8E), G(0x0C8F),         /* 0x08 */
+        G(0x0C90), G_, G(0x0C92), G(0x0C93), G(0x0C94), G(0x0C95), G(0x0C96), G(0x0C97),         /* 0x10 */
+        G(0x0C98), G(0x0C99), G(0x0C9A), G_, G(0x0C9B), G(0x0C9C), G(0x0C9D), G(0x0C9E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0C9F), G(0x0CA0), G(0x0CA1), G(0x0CA2), G(0x0CA3), G(0x0CA4),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0CA5), G(0x0CA6), G(0x002C), G(0x0CA7), G(0x002E), G(0x0CA8),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x0CAA), G(0x0CAB), G(0x003F),         /* 0x38 */
+        G(0x0CAC), G(0x0CAD), G(0x0CAE), G(0x0CAF), G(0x0CB0), G(0x0CB1), G(0x0CB2), G(0x0CB3),  /* 0x40 */
+        G_, G(0x0CB5), G(0x0CB6), G(0x0CB7), G(0x0CB8), G(0x0CB9), G(0x0CBC), G(0x0CBD),         /* 0x48 */
+        G(0x0CBE), G(0x0CBF), G(0x0CC0), G(0x0CC1), G(0x0CC2), G(0x0CC3), G(0x0CC4), G_,         /* 0x50 */
+        G(0x0CC6), G(0x0CC7), G(0x0CC8), G_, G(0x0CCA), G(0x0CCB), G(0x0CCC), G(0x0CCD),         /* 0x58 */
+        G(0x0CD5), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0CD6), G(0x0CE0), G(0x0CE1), G(0x0CE2), G(0x0CE3),  /* 0x78 */
+    },
+    /* GSM_TBL_MALAYALAM_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0D66), G(0x0D67), G(0x0D68), G(0x0D69),         /* 0x18 */
+        G(0x0D6A), G(0x0D6B), G(0x0D6C), G(0x0D6D), G(0x0D6E), G(0x0D6F), G(0x0D70), G(0x0D71),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0D72), G(0x0D73), G(0x0D74), G(0x0D75), G(0x0D7A), G(0x005C),  /* 0x28 */
+        G(0x0D7B), G(0x0D7C), G(0x0D7D), G(0x0D7E), G(0x0D7F), G_, G_, G_,                       /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_MALAYALAM_L */ {
+        G_, G(0x0D02), G(0x0D03), G(0x0D05), G(0x0D06), G(0x0D07), G(0x0D08), G(0x0D09),         /* 0x00 */
+        G(0x0D0A), G(0x0D0B), G(0x000A), G(0x0D0C), G_, G(0x000D), G(0x0D0E), G(0x0D0F),         /* 0x08 */
+        G(0x0D10), G_, G(0x0D12), G(0x0D13), G(0x0D14), G(0x0D15), G(0x0D16), G(0x0D17),         /* 0x10 */
+        G(0x0D18), G(0x0D19), G(0x0D1A), G_, G(0x0D1B), G(0x0D1C), G(0x0D1D), G(0x0D1E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0D1F), G(0x0D20), G(0x0D21), G(0x0D22), G(0x0D23), G(0x0D24),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0D25), G(0x0D26), G(0x002C), G(0x0D27), G(0x002E), G(0x0D28),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x0D2A), G(0x0D2B), G(0x003F),         /* 0x38 */
+        G(0x0D2C), G(0x0D2D), G(0x0D2E), G(0x0D2F), G(0x0D30), G(0x0D31), G(0x0D32), G(0x0D33),  /* 0x40 */
+        G(0x0D34), G(0x0D35), G(0x0D36), G(0x0D37), G(0x0D38), G(0x0D39), G_, G(0x0D3D),         /* 0x48 */
+        G(0x0D3E), G(0x0D3F), G(0x0D40), G(0x0D41), G(0x0D42), G(0x0D43), G(0x0D44), G_,         /* 0x50 */
+        G(0x0D46), G(0x0D47), G(0x0D48), G_, G(0x0D4A), G(0x0D4B), G(0x0D4C), G(0x0D4D),         /* 0x58 */
+        G(0x0D57), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0D60), G(0x0D61), G(0x0D62), G(0x0D63), G(0x0D79),  /* 0x78 */
+    },
+    /* GSM_TBL_ORIYA_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0B66), G(0x0B67), G(0x0B68), G(0x0B69),         /* 0x18 */
+        G(0x0B6A), G(0x0B6B), G(0x0B6C), G(0x0B6D), G(0x0B6E), G(0x0B6F), G(0x0B5C), G(0x0B5D),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0B5F), G(0x0B70), G(0x0B71), G_, G_, G(0x005C),                /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_ORIYA_L */ {
+        G(0x0B01), G(0x0B02), G(0x0B03), G(0x0B05), G(0x0B06), G(0x0B07), G(0x0B08), G(0x0B09),  /* 0x00 */
+        G(0x0B0A), G(0x0B0B), G(0x000A), G(0x0B0C), G_, G(0x000D), G_, G(0x0B0F),                /* 0x08 */
+        G(0x0B10), G_, G_, G(0x0B13), G(0x0B14), G(0x0B15), G(0x0B16), G(0x0B17),                /* 0x10 */
+        G(0x0B18), G(0x0B19), G(0x0B1A), G_, G(0x0B1B), G(0x0B1C), G(0x0B1D), G(0x0B1E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0B1F), G(0x0B20), G(0x0B21), G(0x0B22), G(0x0B23), G(0x0B24),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0B25), G(0x0B26), G(0x002C), G(0x0B27), G(0x002E), G(0x0B28),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x0B2A), G(0x0B2B), G(0x003F),         /* 0x38 */
+        G(0x0B2C), G(0x0B2D), G(0x0B2E), G(0x0B2F), G(0x0B30), G_, G(0x0B32), G(0x0B33),         /* 0x40 */
+        G_, G(0x0B35), G(0x0B36), G(0x0B37), G(0x0B38), G(0x0B39), G(0x0B3C), G(0x0B3D),         /* 0x48 */
+        G(0x0B3E), G(0x0B3F), G(0x0B40), G(0x0B41), G(0x0B42), G(0x0B43), G(0x0B44), G_,         /* 0x50 */
+        G_, G(0x0B47), G(0x0B48), G_, G_, G(0x0B4B), G(0x0B4C), G(0x0B4D),                       /* 0x58 */
+        G(0x0B56), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0B57), G(0x0B60), G(0x0B61), G(0x0B62), G(0x0B63),  /* 0x78 */
+    },
+    /* GSM_TBL_PUNJABI_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0A66), G(0x0A67), G(0x0A68), G(0x0A69),         /* 0x18 */
+        G(0x0A6A), G(0x0A6B), G(0x0A6C), G(0x0A6D), G(0x0A6E), G(0x0A6F), G(0x0A59), G(0x0A5A),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0A5B), G(0x0A5C), G(0x0A5E), G(0x0A75), G_, G(0x005C),         /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_PUNJABI_L */ {
+        G(0x0A01), G(0x0A02), G(0x0A03), G(0x0A05), G(0x0A06), G(0x0A07), G(0x0A08), G(0x0A09),  /* 0x00 */
+        G(0x0A0A), G_, G(0x000A), G_, G_, G(0x000D), G_, G(0x0A0F),                              /* 0x08 */
+        G(0x0A10), G_, G_, G(0x0A13), G(0x0A14), G(0x0A15), G(0x0A16), G(0x0A17),                /* 0x10 */
+        G(0x0A18), G(0x0A19), G(0x0A1A), G_, G(0x0A1B), G(0x0A1C), G(0x0A1D), G(0x0A1E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0A1F), G(0x0A20), G(0x0A21), G(0x0A22), G(0x0A23), G(0x0A24),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0A25), G(0x0A26), G(0x002C), G(0x0A27), G(0x002E), G(0x0A28),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x0A2A), G(0x0A2B), G(0x003F),         /* 0x38 */
+        G(0x0A2C), G(0x0A2D), G(0x0A2E), G(0x0A2F), G(0x0A30), G_, G(0x0A32), G(0x0A33),         /* 0x40 */
+        G_, G(0x0A35), G(0x0A36), G_, G(0x0A38), G(0x0A39), G(0x0A3C), G_,                       /* 0x48 */
+        G(0x0A3E), G(0x0A3F), G(0x0A40), G(0x0A41), G(0x0A42), G_, G_, G_,                       /* 0x50 */
+        G_, G(0x0A47), G(0x0A48), G_, G_, G(0x0A4B), G(0x0A4C), G(0x0A4D),                       /* 0x58 */
+        G(0x0A51), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0A70), G(0x0A71), G(0x0A72), G(0x0A73), G(0x0A74),  /* 0x78 */
+    },
+    /* GSM_TBL_TAMIL_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0964), G(0x0965), G_, G(0x0BE6), G(0x0BE7), G(0x0BE8), G(0x0BE9),         /* 0x18 */
+        G(0x0BEA), G(0x0BEB), G(0x0BEC), G(0x0BED), G(0x0BEE), G(0x0BEF), G(0x0BF3), G(0x0BF4),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0BF5), G(0x0BF6), G(0x0BF7), G(0x0BF8), G(0x0BFA), G(0x005C),  /* 0x28 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_TAMIL_L */ {
+        G_, G(0x0B82), G(0x0B83), G(0x0B85), G(0x0B86), G(0x0B87), G(0x0B88), G(0x0B89),         /* 0x00 */
+        G(0x0B8A), G_, G(0x000A), G_, G_, G(0x000D), G(0x0B8E), G(0x0B8F),                       /* 0x08 */
+        G(0x0B90), G_, G(0x0B92), G(0x0B93), G(0x0B94), G(0x0B95), G_, G_,                       /* 0x10 */
+        G_, G(0x0B99), G(0x0B9A), G_, G_, G(0x0B9C), G_, G(0x0B9E),                              /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0B9F), G_, G_, G_, G(0x0BA3), G(0x0BA4),                       /* 0x20 */
+        G(0x0029), G(0x0028), G_, G_, G(0x002C), G_, G(0x002E), G(0x0BA8),                       /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G(0x0BA9), G(0x0BAA), G_, G(0x003F),         /* 0x38 */
+        G_, G_, G(0x0BAE), G(0x0BAF), G(0x0BB0), G(0x0BB1), G(0x0BB2), G(0x0BB3),                /* 0x40 */
+        G(0x0BB4), G(0x0BB5), G(0x0BB6), G(0x0BB7), G(0x0BB8), G(0x0BB9), G_, G_,                /* 0x48 */
+        G(0x0BBE), G(0x0BBF), G(0x0BC0), G(0x0BC1), G(0x0BC2), G_, G_, G_,                       /* 0x50 */
+        G(0x0BC6), G(0x0BC7), G(0x0BC8), G_, G(0x0BCA), G(0x0BCB), G(0x0BCC), G(0x0BCD),         /* 0x58 */
+        G(0x0BD0), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0BD7), G(0x0BF0), G(0x0BF1), G(0x0BF2), G(0x0BF9),  /* 0x78 */
+    },
+    /* GSM_TBL_TELUGU_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G_, G_, G_, G(0x0C66), G(0x0C67), G(0x0C68), G(0x0C69),                       /* 0x18 */
+        G(0x0C6A), G(0x0C6B), G(0x0C6C), G(0x0C6D), G(0x0C6E), G(0x0C6F), G(0x0C58), G(0x0C59),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x0C78), G(0x0C79), G(0x0C7A), G(0x0C7B), G(0x0C7C), G(0x005C),  /* 0x28 */
+        G(0x0C7D), G(0x0C7E), G(0x0C7F), G_, G_, G_, G_, G_,                                     /* 0x30 */
+        G_, G_, G_, G_, G(0x005B), G(0x007E), G(0x005D), G_,                                     /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_TELUGU_L */ {
+        G(0x0C01), G(0x0C02), G(0x0C03), G(0x0C05), G(0x0C06), G(0x0C07), G(0x0C08), G(0x0C09),  /* 0x00 */
+        G(0x0C0A), G(0x0C0B), G(0x000A), G(0x0C0C), G_, G(0x000D), G(0x0C0E), G(0x0C0F),         /* 0x08 */
+        G(0x0C10), G_, G(0x0C12), G(0x0C13), G(0x0C14), G(0x0C15), G(0x0C16), G(0x0C17),         /* 0x10 */
+        G(0x0C18), G(0x0C19), G(0x0C1A), G_, G(0x0C1B), G(0x0C1C), G(0x0C1D), G(0x0C1E),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x0C1F), G(0x0C20), G(0x0C21), G(0x0C22), G(0x0C23), G(0x0C24),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0C25), G(0x0C26), G(0x002C), G(0x0C27), G(0x002E), G(0x0C28),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G_, G(0x0C2A), G(0x0C2B), G(0x003F),         /* 0x38 */
+        G(0x0C2C), G(0x0C2D), G(0x0C2E), G(0x0C2F), G(0x0C30), G(0x0C31), G(0x0C32), G(0x0C33),  /* 0x40 */
+        G_, G(0x0C35), G(0x0C36), G(0x0C37), G(0x0C38), G(0x0C39), G_, G(0x0C3D),                /* 0x48 */
+        G(0x0C3E), G(0x0C3F), G(0x0C40), G(0x0C41), G(0x0C42), G(0x0C43), G(0x0C44), G_,         /* 0x50 */
+        G(0x0C46), G(0x0C47), G(0x0C48), G_, G(0x0C4A), G(0x0C4B), G(0x0C4C), G(0x0C4D),         /* 0x58 */
+        G(0x0C55), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0C56), G(0x0C60), G(0x0C61), G(0x0C62), G(0x0C63),  /* 0x78 */
+    },
+    /* GSM_TBL_URDU_S */ {
+        G(0x0040), G(0x00A3), G(0x0024), G(0x00A5), G(0x00BF), G(0x0022), G(0x00A4), G(0x0025),  /* 0x00 */
+        G(0x0026), G(0x0027), G(0x000A), G(0x002A), G(0x002B), G_, G(0x002D), G(0x002F),         /* 0x08 */
+        G(0x003C), G(0x003D), G(0x003E), G(0x00A1), G(0x005E), G(0x00A1), G(0x005F), G(0x0023),  /* 0x10 */
+        G(0x002A), G(0x0600), G(0x0601), G_, G(0x06F0), G(0x06F1), G(0x06F2), G(0x06F3),         /* 0x18 */
+        G(0x06F4), G(0x06F5), G(0x06F6), G(0x06F7), G(0x06F8), G(0x06F9), G(0x060C), G(0x060D),  /* 0x20 */
+        G(0x007B), G(0x007D), G(0x060E), G(0x060F), G(0x0610), G(0x0611), G(0x0612), G(0x005C),  /* 0x28 */
+        G(0x0613), G(0x0614), G(0x061B), G(0x061F), G(0x0640), G(0x0652), G(0x0658), G(0x066B),  /* 0x30 */
+        G(0x066C), G(0x0672), G(0x0673), G(0x06CD), G(0x005B), G(0x007E), G(0x005D), G(0x06D4),  /* 0x38 */
+        G(0x007C), G(0x0041), G(0x0042), G(0x0043), G(0x0044), G(0x0045), G(0x0046), G(0x0047),  /* 0x40 */
+        G(0x0048), G(0x0049), G(0x004A), G(0x004B), G(0x004C), G(0x004D), G(0x004E), G(0x004F),  /* 0x48 */
+        G(0x0050), G(0x0051), G(0x0052), G(0x0053), G(0x0054), G(0x0055), G(0x0056), G(0x0057),  /* 0x50 */
+        G(0x0058), G(0x0059), G(0x005A), G_, G_, G_, G_, G_,                                     /* 0x58 */
+        G_, G_, G_, G_, G_, G(0x20AC), G_, G_,                                                   /* 0x60 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x68 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x70 */
+        G_, G_, G_, G_, G_, G_, G_, G_,                                                          /* 0x78 */
+    },
+    /* GSM_TBL_URDU_L */ {
+        G(0x0627), G(0x0622), G(0x0628), G(0x067B), G(0x0680), G(0x067E), G(0x06A6), G(0x062A),  /* 0x00 */
+        G(0x06C2), G(0x067F), G(0x000A), G(0x0679), G(0x067D), G(0x000D), G(0x067A), G(0x067C),  /* 0x08 */
+        G(0x062B), G(0x062C), G(0x0681), G(0x0684), G(0x0683), G(0x0685), G(0x0686), G(0x0687),  /* 0x10 */
+        G(0x062D), G(0x062E), G(0x062F), G_, G(0x068C), G(0x0688), G(0x0689), G(0x068A),         /* 0x18 */
+        G(0x0020), G(0x0021), G(0x068F), G(0x068D), G(0x0630), G(0x0631), G(0x0691), G(0x0693),  /* 0x20 */
+        G(0x0029), G(0x0028), G(0x0699), G(0x0632), G(0x002C), G(0x0696), G(0x002E), G(0x0698),  /* 0x28 */
+        G(0x0030), G(0x0031), G(0x0032), G(0x0033), G(0x0034), G(0x0035), G(0x0036), G(0x0037),  /* 0x30 */
+        G(0x0038), G(0x0039), G(0x003A), G(0x003B), G(0x069A), G(0x0633), G(0x0634), G(0x003F),  /* 0x38 */
+        G(0x0635), G(0x0636), G(0x0637), G(0x0638), G(0x0639), G(0x0641), G(0x0642), G(0x06A9),  /* 0x40 */
+        G(0x06AA), G(0x06AB), G(0x06AF), G(0x06B3), G(0x06B1), G(0x0644), G(0x0645), G(0x0646),  /* 0x48 */
+        G(0x06BA), G(0x06BB), G(0x06BC), G(0x0648), G(0x06C4), G(0x06D5), G(0x06C1), G(0x06BE),  /* 0x50 */
+        G(0x0621), G(0x06CC), G(0x06D0), G(0x06D2), G(0x064D), G(0x0650), G(0x064F), G(0x0657),  /* 0x58 */
+        G(0x0654), G(0x0061), G(0x0062), G(0x0063), G(0x0064), G(0x0065), G(0x0066), G(0x0067),  /* 0x60 */
+        G(0x0068), G(0x0069), G(0x006A), G(0x006B), G(0x006C), G(0x006D), G(0x006E), G(0x006F),  /* 0x68 */
+        G(0x0070), G(0x0071), G(0x0072), G(0x0073), G(0x0074), G(0x0075), G(0x0076), G(0x0077),  /* 0x70 */
+        G(0x0078), G(0x0079), G(0x007A), G(0x0655), G(0x0651), G(0x0653), G(0x0656), G(0x0670),  /* 0x78 */
+    },
+};
+
+#undef G
+#undef G_
+
+/* X(language, single shift table, locking shift table) of every LANG_SHIFT_* */
+#define GSM_LANG_TABLES(X)                          \
+    X(GSM7BIT, DEFAULT_EX, DEFAULT)                 \
+    X(TURKISH, TURKISH_S, TURKISH_L)                \
+    X(SPANISH, SPANISH_S, DEFAULT)                  \
+    X(PORTUGUESE, PORTUGUESE_S, PORTUGUESE_L)       \
+    X(BENGALI, BENGALI_S, BENGALI_L)                \
+    X(GUJARATI, GUJARATI_S, GUJARATI_L)             \
+    X(HINDI, HINDI_S, HINDI_L)                      \
+    X(KANNADA, KANNADA_S, KANNADA_L)                \
+    X(MALAYALAM, MALAYALAM_S, MALAYALAM_L)          \
+    X(ORIYA, ORIYA_S, ORIYA_L)                      \
+    X(PUNJABI, PUNJABI_S, PUNJABI_L)                \
+    X(TAMIL, TAMIL_S, TAMIL_L)                      \
+    X(TELUGU, TELUGU_S, TELUGU_L)                   \
+    X(URDU, URDU_S, URDU_L)
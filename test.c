@@ -77,6 +77,23 @@ int main(int argc, char *argv[])
     char list[50] = "1,23,4,5,6,,78,,,9,,";
     char list_a[100] = "123,456,789,111,222,333,444,55,66,77,88";
     char list_b[100] = "123,456,789,111,222,333,444,,,11,22,9999,8888,hello,  33";
+    /* "Hello World!" in 7-bit ascii, packed */
+    static const unsigned char asc7bit[] = {
+        0x91, 0x97, 0x66, 0xCD, 0xE8, 0x2B, 0xEF, 0xE5, 0xB3, 0x22, 0x10,
+    };
+    /* two 26 octets EF_ADN records, GSM and 0x81 UCS2 coded alpha */
+    static const unsigned char adn[] = {
+        'A', 'l', 'i', 'c', 'e', 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0x06, 0x91, 0x31, 0x42, 0x65, 0x87, 0xF9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0x81, 0x05, 0x08, 0xAA, 0xAD, 0x20, 0x41, 0x9B, 0xFF, 0xFF, 0xFF, 0xFF,
+        0x03, 0x81, 0x21, 0x43, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    };
+    struct tiny_adn_record *recs;
+    tiny_string_set *set;
+    struct tiny_string_list_iter iter;
+    const char *item;
+    size_t len;
+    char *utf8;
     char **array;
     int i, cnt, res;
 
@@ -86,6 +103,166 @@ int main(int argc, char *argv[])
     printf("FROM UTF16LE to UTF8:\n================================\n");
     printf("%s\n", tiny_utf_to_utf8(utf16le, sizeof(utf16le), UTF_CODING_UTF16LE));
 
+    printf("UTF8 code points:\n ==============================================\n");
+    utf8 = tiny_utf_to_utf8(utf16be, sizeof(utf16be), UTF_CODING_UTF16BE);
+    len = strlen(utf8);
+    printf("%zu bytes, %zu code points, first 20: \"%.*s\"\n", len, tiny_utf8_count(utf8, len),
+           (int)tiny_utf8_skip(utf8, len, 20), utf8);
+    free(utf8);
+
+    printf("UTF16BE code point iterator:\n ==============================================\n");
+    {
+        struct tiny_utf_iter it;
+        unsigned int cp;
+
+        tiny_utf_iter_init(&it, utf16be, 16);
+        while(tiny_utf16be_next(&it, &cp) > 0)
+            printf("U+%04X ", cp);
+        printf("\n");
+    }
+
+    printf("UTF16BE preview:\n ==============================================\n");
+    utf8 = tiny_utf_to_utf8_range(utf16be, sizeof(utf16be), UTF_CODING_UTF16BE, 14, -1, &res);
+    printf("\"%s\", resume at byte %d\n", utf8, res);
+    free(utf8);
+
+    printf("lossy UTF8 to UTF16BE:\n ==============================================\n");
+    {
+        static const char dirty[] = "ok\xffgo\xe2\x82!";
+        unsigned char obuf[32];
+        void *i = (void *)dirty, *o = obuf;
+        size_t isz = sizeof(dirty) - 1, osz = sizeof(obuf), nsubst;
+
+        res = tiny_utf_convert_ex(UTF_CODING_UTF8, &i, &isz, UTF_CODING_UTF16BE, &o, &osz,
+                                  UTF_CONV_REPLACE, 0, &nsubst);
+        printf("result %d, %zu replaced\n", res, nsubst);
+        tiny_hex_dump(0, (const char *)obuf, sizeof(obuf) - osz);
+    }
+
+    printf("CP1252 round trip through LATIN1:\n ==============================================\n");
+    {
+        static const char legacy[] = "\x93" "caf\xe9\x94 \x80" "5";
+        char l1[16];
+        void *i = (void *)legacy, *o = l1;
+        size_t isz = sizeof(legacy) - 1, osz = sizeof(l1), nsubst;
+
+        utf8 = tiny_utf_to_utf8(legacy, sizeof(legacy) - 1, UTF_CODING_CP1252);
+        printf("\"%s\"\n", utf8);
+        free(utf8);
+        res = tiny_utf_convert_ex(UTF_CODING_CP1252, &i, &isz, UTF_CODING_LATIN1, &o, &osz,
+                                  UTF_CONV_REPLACE, 0, &nsubst);
+        printf("result %d, %zu unmappable\n", res, nsubst);
+        tiny_hex_dump(0, l1, sizeof(l1) - osz);
+    }
+
+    printf("detected coding:\n ==============================================\n");
+    res = tiny_utf_detect(utf16be, sizeof(utf16be), &cnt, NULL);
+    printf("utf16be: %d, confidence %d\n", res, cnt);
+    res = tiny_utf_detect(utf16le, sizeof(utf16le), &cnt, NULL);
+    printf("utf16le: %d, confidence %d\n", res, cnt);
+
+    printf("asc7bit packed:\n ==============================================\n");
+    printf("\"%s\"\n", tiny_decode_asc7bit_packed(asc7bit, 12, 0));
+
+    printf("decode cache:\n ==============================================\n");
+    {
+        struct tiny_decode_cache_stats st;
+        tiny_decode_cache *cache = tiny_decode_cache_new(64);
+        const char *s1, *s2;
+
+        s1 = tiny_decode_cache_ucs16be(cache, (const unsigned char *)utf16be, 16);
+        s2 = tiny_decode_cache_ucs16be(cache, (const unsigned char *)utf16be, 16);
+        tiny_decode_cache_stats(cache, &st);
+        printf("\"%s\" %s, hits %llu misses %llu\n", s2, s1 == s2 ? "shared" : "copied",
+               st.hits, st.misses);
+        tiny_decode_cache_release(s1);
+        tiny_decode_cache_release(s2);
+        tiny_decode_cache_free(cache);
+    }
+
+    printf("GSM 7 bit encode, transliterated:\n ==============================================\n");
+    {
+        static const char smart[] = "\xe2\x80\x9cna\xc3\xafve\xe2\x80\x9d \xe2\x80\x94 ok\xe2\x80\xa6";
+        unsigned char pdu[32];
+        char *txt;
+
+        cnt = tiny_encode_gsm7bit_packed_r(smart, sizeof(smart) - 1, 0, LANG_SHIFT_GSM7BIT,
+                                           LANG_SHIFT_GSM7BIT, GSM_ENC_TRANSLIT, pdu, sizeof(pdu));
+        txt = tiny_decode_gsm7bit_packed(pdu, cnt, 0);
+        printf("%d septets: \"%s\"\n", cnt, txt);
+        free(txt);
+    }
+
+    printf("GSM 7 bit Hindi shift tables:\n ==============================================\n");
+    {
+        /* "नमस्ते 2024" */
+        static const char hindi[] = "\xe0\xa4\xa8\xe0\xa4\xae\xe0\xa4\xb8\xe0\xa5\x8d\xe0\xa4\xa4"
+                                    "\xe0\xa5\x87 2024";
+        unsigned char pdu[32];
+        char *txt;
+
+        cnt = tiny_encode_gsm7bit_packed_r(hindi, sizeof(hindi) - 1, 0, LANG_SHIFT_HINDI,
+                                           LANG_SHIFT_HINDI, 0, pdu, sizeof(pdu));
+        txt = tiny_decode_gsm7bit_packed_ex(pdu, cnt, 0, LANG_SHIFT_HINDI, LANG_SHIFT_HINDI);
+        printf("%d septets: \"%s\"\n", cnt, txt);
+        free(txt);
+    }
+
+    printf("USSD:\n ==============================================\n");
+    {
+        unsigned char pdu[16];
+        char txt[64];
+
+        cnt = tiny_encode_ussd_r("*100#", 5, 0x0F, NULL, pdu, sizeof(pdu));
+        tiny_hex_dump(0, (const char *)pdu, cnt);
+        tiny_decode_ussd_r(pdu, cnt, 0x0F, txt, sizeof(txt), NULL);
+        printf("\"%s\"\n", txt);
+    }
+
+    printf("CBS:\n ==============================================\n");
+    {
+        static const char *body[] = {"Flood warning for the river valley, ", "move to higher ground."};
+        unsigned char pages[2][CBS_PAGE_SIZE];
+        struct tiny_cbs_message *msg;
+        tiny_cbs_assembler *cbs;
+        char septets[93];
+        int order[] = {2, 2, 1};
+
+        /* serial 0x1230, message id 4370, GSM 7 bit, "\r" padded */
+        for(i = 0; i < 2; i++)  {
+            memcpy(pages[i], "\x12\x30\x11\x12\x0F", 5);
+            pages[i][5] = ((i + 1) << 4) | 2;
+            memset(septets, '\r', sizeof(septets));
+            memcpy(septets, body[i], strlen(body[i]));
+            tiny_encode_gsm7bit_packed_r(septets, sizeof(septets), 0, 0, 0, 0,
+                                         pages[i] + 6, CBS_CONTENT_SIZE);
+        }
+
+        if((cbs = tiny_cbs_assembler_new(16)))  {
+            for(i = 0; i < (int)(sizeof(order) / sizeof(order[0])); i++)  {
+                cnt = tiny_cbs_assembler_feed(cbs, pages[order[i] - 1], CBS_PAGE_SIZE, &msg);
+                printf("page %d: %d\n", order[i], cnt);
+                if(msg)  {
+                    printf("%04X %u, %d pages: \"%s\"\n", msg->serial, msg->msg_id, msg->pages, msg->text);
+                    free(msg);
+                }
+            }
+            tiny_cbs_assembler_free(cbs);
+        }
+
+        pages[0][5] = 0x11;
+        if((msg = tiny_decode_cbs_page(pages[0], CBS_PAGE_SIZE)))  {
+            printf("lone page, %d pages: \"%s\"\n", msg->pages, msg->text);
+            free(msg);
+        }
+    }
+
+    printf("EF_ADN:\n ==============================================\n");
+    recs = tiny_decode_adn_ef(adn, sizeof(adn), 26, &cnt);
+    for(i = 0; i < cnt; i++)
+        printf("%d:\"%s\" \"%s\"\n", recs[i].index, recs[i].alpha, recs[i].number);
+    free(recs);
+
     printf("trim NONE:\n ==============================================\n");
     printf("\"%s\"\n", tiny_string_trim(a, NULL, 0));
     printf("\"%s\"\n", tiny_string_trim(b, NULL, 0));
@@ -131,6 +308,12 @@ int main(int argc, char *argv[])
     printf("\"%s\"\n", tiny_string_trim(f, NULL, TRIM_END));
     printf("\"%s\"\n", tiny_string_trim(g, NULL, TRIM_END));
 
+    printf("trim view:\n ==============================================\n");
+    item = tiny_string_trim_view(a, NULL, &len);
+    printf("\"%.*s\"\n", (int)len, item);
+    item = tiny_string_trim_view(g, NULL, &len);
+    printf("\"%.*s\"\n", (int)len, item);
+
     printf("split:\n ==============================================\n");
     printf("\"%s\"\n", list);
     array = tiny_string_list_split(list, NULL, &cnt);
@@ -139,6 +322,10 @@ int main(int argc, char *argv[])
         printf("split:\"%s\"\n", array[i]);
     free(array);
 
+    tiny_string_list_iter_init(&iter, list, NULL);
+    while((item = tiny_string_list_iter_next(&iter, &len)))
+        printf("iter:\"%.*s\"\n", (int)len, item);
+
     printf("insert: ===========================================\n");
     printf("\"%s\"\n", list);
     res = tiny_string_list_insert(list, NULL, sizeof(list), "911");
@@ -190,6 +377,20 @@ int main(int argc, char *argv[])
 
     res = tiny_string_list_concat(list_a, NULL, sizeof(list_a), list_b);
     printf("\"O: %s\" %d\n", list_a, res);
+
+    printf("set: ===========================================\n");
+    set = tiny_string_set_new(list_a, NULL);
+    res = tiny_string_set_find(set, "hello");
+    printf("%d:%s\n", res, "hello");
+    res = tiny_string_set_remove(set, "hello");
+    printf("%d:%s\n", res, "hello");
+    res = tiny_string_set_find(set, "hello");
+    printf("%d:%s\n", res, "hello");
+    res = tiny_string_set_insert(set, "12345");
+    printf("%d:%s\n", res, "12345");
+    res = tiny_string_set_serialize(set, NULL, list_a, sizeof(list_a));
+    printf("\"O: %s\" %d\n", list_a, res);
+    tiny_string_set_free(set);
     return 0;
 }
 
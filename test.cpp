@@ -0,0 +1,75 @@
+/*
+ * UTF encoding conversion utils.
+ * Copyright (C) <2018>  Crs Chin<crs.chin@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "tinycode.hpp"
+
+using tiny::coding;
+
+static void print_result(const char *what, const tiny::result &res)
+{
+    printf("%s: err %d, read %zu, written %zu, replaced %zu\n",
+           what, res.err, res.read, res.written, res.replaced);
+}
+
+int main(int argc, char *argv[])
+{
+    const std::string bad(40, '\xff');
+    std::string out;
+    tiny::result res;
+
+    printf("reused string:\n ==============================================\n");
+    out.reserve(8);
+    res = tiny::convert<coding::utf8, coding::utf16be>("h\xc3\xa9llo w\xc3\xb6rld, grown past 8 bytes", out);
+    print_result("UTF8>UTF16BE", res);
+    res = tiny::convert<coding::utf16be, coding::utf8>(std::string(out), out);
+    print_result("UTF16BE>UTF8", res);
+    printf("\"%s\"\n", out.c_str());
+
+    printf("substitute above U+FFFF:\n ==============================================\n");
+    out.clear();
+    out.shrink_to_fit();
+    res = tiny::convert<coding::utf8, coding::utf8>(bad, out, UTF_CONV_REPLACE, 0x1F600);
+    print_result("UTF8>UTF8", res);
+    out.clear();
+    out.shrink_to_fit();
+    res = tiny::convert<coding::utf8, coding::utf16be>(bad, out, UTF_CONV_REPLACE, 0x1F600);
+    print_result("UTF8>UTF16BE", res);
+    out = tiny::convert<coding::utf8, coding::utf8>(bad, std::move(out), UTF_CONV_REPLACE, 0x1F600);
+    printf("rvalue: %zu bytes, %s\n", out.size(), out.substr(0, 8).c_str());
+
+    printf("GSM packed into a reused string:\n ==============================================\n");
+    {
+        std::string pdu, fresh;
+
+        tiny::gsm::alphabet<>::encode_packed("a longer earlier message", 0, 0, pdu);
+        tiny::gsm::alphabet<>::encode_packed("hi", 12, 0, pdu);
+        tiny::gsm::alphabet<>::encode_packed("hi", 12, 0, fresh);
+        printf("%zu octets, %s\n", pdu.size(), pdu == fresh ? "same as fresh" : "differs");
+    }
+
+    printf("GSM alphabet:\n ==============================================\n");
+    printf("ESC 0x65: U+%04X, Turkish 0x07: U+%04X\n",
+           (unsigned int)tiny::gsm::alphabet<>::code_point(0x65, true),
+           (unsigned int)tiny::gsm::alphabet<LANG_SHIFT_TURKISH>::code_point(0x07));
+    return 0;
+}
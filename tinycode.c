@@ -21,8 +21,15 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <stdlib.h>
-#include <stdarg.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "tinycode.h"
 
@@ -40,126 +47,72 @@ struct _utf_coding{
 static int utf_encode_8(void **buf, size_t *size, unsigned int cp);
 static int utf_encode_16be(void **buf, size_t *size, unsigned int cp);
 static int utf_encode_16le(void **buf, size_t *size, unsigned int cp);
+static int utf_encode_latin1(void **buf, size_t *size, unsigned int cp);
+static int utf_encode_cp1252(void **buf, size_t *size, unsigned int cp);
+static int utf_encode_ascii(void **buf, size_t *size, unsigned int cp);
 
 static int utf_decode_8(void **buf, size_t *size, unsigned int *cp);
 static int utf_decode_16be(void **buf, size_t *size, unsigned int *cp);
 static int utf_decode_16le(void **buf, size_t *size, unsigned int *cp);
+static int utf_decode_latin1(void **buf, size_t *size, unsigned int *cp);
+static int utf_decode_cp1252(void **buf, size_t *size, unsigned int *cp);
+static int utf_decode_ascii(void **buf, size_t *size, unsigned int *cp);
 
 static const utf_coding utf_coding_table[] = {
     {UTF_CODING_UTF8, "UTF8", utf_encode_8, utf_decode_8,},
     {UTF_CODING_UTF16BE, "UTF16BE", utf_encode_16be, utf_decode_16be,},
     {UTF_CODING_UTF16LE, "UTF16LE", utf_encode_16le, utf_decode_16le,},
+    {UTF_CODING_LATIN1, "LATIN1", utf_encode_latin1, utf_decode_latin1,},
+    {UTF_CODING_CP1252, "CP1252", utf_encode_cp1252, utf_decode_cp1252,},
+    {UTF_CODING_ASCII, "ASCII", utf_encode_ascii, utf_decode_ascii,},
 };
 
-static const char bcd_tbl[] = {
-    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '*', '#', 'a', 'b', 'c', 
-};
-
-
-static const char cdma_bcd_tbl[] = {
-    '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '*', '#',
-};
-
-static const char *gsm_alphabet[] = {
-    "@", "£", "$", "¥", "è", "é", "ù", "ì", "ò", "Ç", "\n", "Ø", "ø", "\r", "Å", "å", /* 0x00 */
-    "Δ", "_", "Φ", "Γ", "Λ", "Ω", "Π", "Ψ", "Σ", "Θ", "Ξ", "\x1B", "Æ", "æ", "ß", "É", /* 0x10 */
-    " ", "!", "\"", "#", "¤", "%", "&", "'", "(", ")", "*", "+", ",", "-", ".", "/", /* 0x20 */
-    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":", ";", "<", "=", ">", "?", /* 0x30 */
-    "¡", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O", /* 0x40 */
-    "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "Ä", "Ö", "Ñ", "Ü", "§", /* 0x50 */
-    "¿", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o", /* 0x60 */
-    "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "ä", "ö", "ñ", "ü", "à", /* 0x70 */
-};
-
-static const char *gsm_alphabet_ex[128] = {
-    [0x0A] = "\n",
-    [0x14] = "^",
-    [0x28] = "{", [0x29] = "}", [0x2F] = "\\",
-    [0x3C] = "[", [0x3D] = "~", [0x3E] = "]",
-    [0x40] = "|",
-    [0x60] = "€",
-};
-
-static const char *single_shift_Turkish[] = {
-    [0x14] = "^",
-    [0x28] = "{", [0x29] = "}", [0x2F] = "\\",
-    [0x3C] = "[", [0x3D] = "~", [0x3E] = "]",
-    [0x40] = "|", [0x47] = "Ğ", [0x49] = "İ",
-    [0x53] = "Ş",
-    [0x63] = "ç", [0x67] = "ğ", [0x69] = "ı",
-    [0x73] = "ş"
+/* other names legacy feeds label the single byte codings with */
+static const struct {
+    const char *name;
+    int coding;
+} utf_coding_alias[] = {
+    {"ISO-8859-1", UTF_CODING_LATIN1,},
+    {"ISO8859-1", UTF_CODING_LATIN1,},
+    {"LATIN-1", UTF_CODING_LATIN1,},
+    {"WINDOWS-1252", UTF_CODING_CP1252,},
+    {"US-ASCII", UTF_CODING_ASCII,},
 };
 
-static const char *locking_shift_Turkish[] = {
-    "@", "£", "$", "¥", "€", "é", "ù", "ı", "ò", "Ç", "\n", "Ğ", "ğ", "\r", "Å", "å",
-    "Δ", "_", "Φ", "Γ", "Λ", "Ω", "Π", "Ψ", "Σ", "Θ", "Ξ", "\x1B", "Ş", "ş", "ß", "É",
-    " ", "!", "\"", "#", "¤", "%", "&", "'", "(", ")", "*", "+", ",", "-", ".", "/", 
-    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":", ";", "<", "=", ">", "?", 
-    "İ", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O",
-    "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "Ä", "Ö", "Ñ", "Ü", "§",
-    "ç", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o",
-    "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "ä", "ö", "ñ", "ü", "à", 
+/* CP1252 0x80 - 0x9F, 0 where undefined, the rest is LATIN1 */
+static const unsigned short cp1252_high[32] = {
+    0x20AC, 0, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0, 0x017D, 0,
+    0, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0, 0x017E, 0x0178,
 };
 
-static const char *single_shift_Spanish[] = {
-    [0x09] = "ç",
-    [0x14] = "^",
-    [0x28] = "{", [0x29] = "}", [0x2F] = "\\",
-    [0x3C] = "[", [0x3D] = "~", [0x3E] = "]",
-    [0x40] = "|", [0x41] = "Á", [0x49] = "Í", [0x4F] = "Ó",
-    [0x55] = "Ú",
-    [0x61] = "á", [0x69] = "í", [0x6F] = "ó",
-    [0x75] = "ú",
+static const char bcd_tbl[] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '*', '#', 'a', 'b', 'c', 
 };
 
-static const char *single_shift_Portuguese[] = {
-    [0x05] = "ê", [0x09] = "ç", [0x0B] = "Ô", [0x0C] = "ô", [0x0E] = "Á", [0x0F] = "á", 
-    [0x12] = "Φ", [0x13] = "Γ", [0x14] = "^", [0x15] = "Ω", [0x16] = "Π", [0x17] = "Ψ", [0x18] = "Σ", [0x19] = "Θ", [0x1F] = "Ê", 
-    [0x28] = "{", [0x29] = "}", [0x2F] = "\\",
-    [0x3C] = "[", [0x3D] = "~", [0x3E] = "]", 
-    [0x41] = "|", [0x42] = "À", [0x49] = "Í", [0x4F] = "Ó", 
-    [0x55] = "Ú", [0x5B] = "Ã", [0x5C] = "Õ", 
-    [0x61] = "Â", [0x65] = "€", [0x69] = "í", [0x6F] = "ó", 
-    [0x75] = "ú", [0x7B] = "ã", [0x7C] = "õ", [0x7F] = "â", 
-};
 
-static const char *locking_shift_Portuguese[] = {
- 	"@", "£", "$", "¥", "ê", "é", "ú", "í", "ó", "ç", "\n", "Ô", "ô", "\r", "Á", "á",
-    "Δ", "_", "ª", "Ç", "À", "∞", "^", "\\", "€", "Ó", "|", "\x1B", "Â", "â", "Ê", "É", 
-    " ", "!", "\"", "#", "º", "%", "&", "'", "(", ")", "*", "+", ",", "-", ".", "/",
-    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":", ";", "<", "=", ">", "?",
-    "Í", "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M", "N", "O",
-    "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z", "Ã", "Õ", "Ú", "Ü", "§",
-    "~", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o",
-    "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z", "ã", "õ", "`", "ü", "à", 
+static const char cdma_bcd_tbl[] = {
+    '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '*', '#',
 };
-#define SHIFT_TABLE(idx,lang)                                           \
-    __SHIFT_TABLE(idx,lang,single_shift_##lang,locking_shift_##lang)
 
-#define SHIFT_TABLE_GSM7BIT(idx,lang)                       \
-    __SHIFT_TABLE(idx,lang,gsm_alphabet_ex,gsm_alphabet)
-
-#define __SHIFT_TABLE(idx,lang,single,locking)  \
-    [idx] = {#lang, single, locking}
+#define GSM_TABLES_STORAGE  static const
+#include "gsm_tables.h"
 
 struct language_shift_table{
-    char *name;
-    const char **single;
-    const char **locking;
+    const char *name;
+    const struct gsm_char *single;
+    const struct gsm_char *locking;
 };
 
-#define LANG_SHIFT_GSM7BIT  0x00
+#define LANG_TABLE(lang,single,locking)                             \
+    [LANG_SHIFT_##lang] = {#lang, gsm_tables[GSM_TBL_##single], gsm_tables[GSM_TBL_##locking]},
 
-static const struct language_shift_table language_shift_table[255] = {
-    SHIFT_TABLE_GSM7BIT(0x00, GSM7BIT),
-    SHIFT_TABLE(0x01, Turkish),
-    __SHIFT_TABLE(0x02, Spanish, single_shift_Spanish, gsm_alphabet),
-    SHIFT_TABLE(0x03, Portuguese),
+static const struct language_shift_table language_shift_table[LANG_SHIFT_MAX] = {
+    GSM_LANG_TABLES(LANG_TABLE)
 };
 
-#undef SHIFT_TABLE
-#undef SHIFT_TABLE_GSM7BIT
-#undef __SHIFT_TABLE
+#undef LANG_TABLE
 
 static const char *mon_tbl[] = {
     "Jan.", "Feb.", "Mar.", "Apr.", "May.", "Jun.", "Jul.", "Aug.", "Sep.", "Oct.", "Nov.", "Dec.",
@@ -173,76 +126,193 @@ static const char *mon_tbl[] = {
  #define BUILD_FAIL_IF(exp) ((void)sizeof(char[1 - 2 * (!!(exp))]))
 #endif
 
-#ifndef _GNU_SOURCE
-#define __INIT_STRING_LEN 100
+#ifndef TINYCODE_NO_STATS
+#include <time.h>
+
+/*
+ * per-thread counters, each thread owns one block and is the only
+ * writer of it, blocks are never freed but retired on thread exit
+ * and adopted by later threads, so totals survive thread churn.
+ */
+struct stat_block {
+    struct tiny_stats stats;
+    struct stat_block *next;
+    int retired;
+};
+
+static struct stat_block *stat_blocks;
+static int stat_enabled;
+static pthread_key_t stat_key;
+static pthread_once_t stat_once = PTHREAD_ONCE_INIT;
+static __thread struct stat_block *stat_self;
+
+/* single writer, relaxed load/store compiles to a plain add */
+#define __STAT_ADD(v, n)                                                \
+    __atomic_store_n(&(v), __atomic_load_n(&(v), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
 
-static int asprintf(char **strp, const char *fmt, ...)
+static void __stat_retire(void *arg)
 {
-    va_list ap;
-    char *buf;
-    size_t len = __INIT_STRING_LEN;
-    int res;
+    __atomic_store_n(&((struct stat_block *)arg)->retired, 1, __ATOMIC_RELEASE);
+}
 
-    if(! strp || ! fmt || ! (buf = (char *)malloc(len)))
-        return -1;
+static void __stat_init(void)
+{
+    pthread_key_create(&stat_key, __stat_retire);
+}
 
-    va_start(ap, fmt);
-    do {
-        res = vsnprintf(buf, len, fmt, ap);
+static struct stat_block *__stat_block(void)
+{
+    struct stat_block *b;
+    int retired = 1;
 
-        if(res >= len) {
-            free(buf);
+    if(stat_self)
+        return stat_self;
 
-            if(! (buf = (char *)malloc(len + __INIT_STRING_LEN))) {
-                res = -1;
-                break;
-            }
+    pthread_once(&stat_once, __stat_init);
+    for(b = __atomic_load_n(&stat_blocks, __ATOMIC_ACQUIRE); b; b = b->next)  {
+        if(__atomic_compare_exchange_n(&b->retired, &retired, 0, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+        retired = 1;
+    }
 
-            len += __INIT_STRING_LEN;
-            va_end(ap);
-            va_start(ap, fmt);
-            continue;
-        }
-    } while(0);
-    va_end(ap);
+    if(! b)  {
+        if(! (b = (struct stat_block *)calloc(1, sizeof(*b))))
+            return NULL;
+        b->next = __atomic_load_n(&stat_blocks, __ATOMIC_RELAXED);
+        while(! __atomic_compare_exchange_n(&stat_blocks, &b->next, b, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
 
-    *strp = buf;
-    return res;
+    pthread_setspecific(stat_key, b);
+    return stat_self = b;
 }
 
-static int vasprintf(char **strp, const char *fmt, va_list _ap)
+/* 0 if disabled, the only cost then */
+static inline unsigned long long __stat_begin(void)
 {
-    va_list ap;
-    char *buf;
-    size_t len = __INIT_STRING_LEN * 10;
-    int res;
+    struct timespec ts;
 
-    if(! strp || ! fmt || ! (buf = (char *)malloc(len)))
-        return -1;
+    if(! __atomic_load_n(&stat_enabled, __ATOMIC_RELAXED))
+        return 0;
 
-    va_copy(ap, _ap);
-    do {
-        res = vsnprintf(buf, len, fmt, ap);
-        if(res >= len) {
-            free(buf);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec + 1;
+}
 
-            if(! (buf = (char *)malloc(len + __INIT_STRING_LEN))) {
-                res = -1;
-                break;
-            }
+static void __stat_end(int id, unsigned long long start, size_t in, size_t out)
+{
+    struct tiny_stat_entry *e;
+    struct stat_block *b;
+    struct timespec ts;
+    unsigned long long ns;
+    int bucket;
+
+    if(! (b = __stat_block()))
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec + 1 - start;
+    bucket = 63 - __builtin_clzll(ns | 1);
+    if(bucket >= TINY_STAT_HIST_BUCKETS)
+        bucket = TINY_STAT_HIST_BUCKETS - 1;
+
+    e = &b->stats.entry[id];
+    __STAT_ADD(e->calls, 1);
+    __STAT_ADD(e->bytes_in, in);
+    __STAT_ADD(e->bytes_out, out);
+    __STAT_ADD(e->hist[bucket], 1);
+}
 
-            len += __INIT_STRING_LEN;
-            va_end(ap);
-            va_copy(ap, _ap);
-            continue;
-        }
-    } while(0);
-    va_end(ap);
+static void __stat_regrow(int id)
+{
+    struct stat_block *b;
 
-    *strp = buf;
-    return res;
+    if(__atomic_load_n(&stat_enabled, __ATOMIC_RELAXED) && (b = __stat_block()))
+        __STAT_ADD(b->stats.entry[id].regrows, 1);
+}
+
+static void __stat_error(int err)
+{
+    struct stat_block *b;
+
+    if(err < 0 && -err < TINY_STAT_ERRORS &&
+       __atomic_load_n(&stat_enabled, __ATOMIC_RELAXED) && (b = __stat_block()))
+        __STAT_ADD(b->stats.errors[-err], 1);
+}
+
+#define STAT_BEGIN(t)               unsigned long long t = __stat_begin()
+#define STAT_END(id, t, in, out)    do { if(t) __stat_end(id, t, in, out); } while(0)
+#define STAT_REGROW(id)             __stat_regrow(id)
+#define STAT_ERROR(err)             __stat_error(err)
+
+void tiny_stats_enable(int enable)
+{
+    __atomic_store_n(&stat_enabled, !! enable, __ATOMIC_RELAXED);
+}
+
+/* lock free aggregation over all thread blocks */
+int tiny_stats_snapshot(struct tiny_stats *stats)
+{
+    const unsigned long *src;
+    unsigned long *dst;
+    struct stat_block *b;
+    unsigned int i;
+
+    if(! stats)
+        return UTF_ERR_BAD_ARG;
+
+    memset(stats, 0, sizeof(*stats));
+    dst = (unsigned long *)stats;
+    for(b = __atomic_load_n(&stat_blocks, __ATOMIC_ACQUIRE); b; b = b->next)  {
+        src = (const unsigned long *)&b->stats;
+        for(i = 0; i < sizeof(*stats) / sizeof(unsigned long); i++)
+            dst[i] += __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+    return UTF_ERR_OK;
+}
+#else
+#define STAT_BEGIN(t)               do {} while(0)
+#define STAT_END(id, t, in, out)    do { (void)(in); (void)(out); } while(0)
+#define STAT_REGROW(id)             do {} while(0)
+#define STAT_ERROR(err)             do {} while(0)
+
+void tiny_stats_enable(int enable)
+{
+}
+
+int tiny_stats_snapshot(struct tiny_stats *stats)
+{
+    if(stats)
+        memset(stats, 0, sizeof(*stats));
+    return UTF_ERR_NO_SUPPORT;
+}
+#endif  /* ! TINYCODE_NO_STATS */
+
+static const char *stat_names[TINY_STAT_MAX] = {
+    [TINY_STAT_UTF_CONVERT] = "utf_convert",
+    [TINY_STAT_UTF_TO_UTF8] = "utf_to_utf8",
+    [TINY_STAT_UCS16BE] = "decode_ucs16be",
+    [TINY_STAT_UNICODE] = "decode_unicode",
+    [TINY_STAT_ASC7BIT_PACKED] = "decode_asc7bit_packed",
+    [TINY_STAT_ASC7BIT_UNPACKED] = "decode_asc7bit_unpacked",
+    [TINY_STAT_GSM7BIT] = "decode_gsm7bit_packed",
+    [TINY_STAT_GSM8BIT] = "decode_gsm8bit_unpacked",
+    [TINY_STAT_UCS2] = "decode_ucs2",
+    [TINY_STAT_ADN] = "decode_adn",
+    [TINY_STAT_ADN_EF] = "decode_adn_ef",
+    [TINY_STAT_IP_ADDR] = "decode_ip_addr",
+    [TINY_STAT_BCD_NUM] = "decode_bcd_num",
+    [TINY_STAT_HEX] = "decode_hex_string",
+};
+
+const char *tiny_stats_name(int id)
+{
+    if(id < 0 || id >= TINY_STAT_MAX)
+        return NULL;
+    return stat_names[id];
 }
-#endif
 
 int tiny_decode_hex(char c)
 {
@@ -260,6 +330,7 @@ char *tiny_decode_hex_string(const char *str, int *len)
     const char *p;
     char *bin, *q;
     int l;
+    STAT_BEGIN(t);
 
     if(! str || ! *str || ! len)
         return NULL;
@@ -278,6 +349,7 @@ char *tiny_decode_hex_string(const char *str, int *len)
         p += 2;
     }
 
+    STAT_END(TINY_STAT_HEX, t, *len * 2, *len);
     return bin;
 }
 
@@ -333,6 +405,9 @@ static int utf_encode_8(void **buf, size_t *size, unsigned int cp)
     if(cp >= 0xD800 && cp <= 0xDFFF) /* fail if fall in UTF16 surrogates */
         return UTF_ERR_BAD_CODE;
 
+    if(! *size)
+        return UTF_ERR_SIZE;
+
     while(*size > 0) {
         if(cp <= 0x7F) {
             *p = cp;
@@ -384,667 +459,3518 @@ static int utf_encode_8(void **buf, size_t *size, unsigned int cp)
     return err;
 }
 
-static inline int __big_endian()
-{
-    int i = 1;
-    return ! *(char *)&i;
-}
+/* byte order of the host, resolved at compile time */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+ #define __HOST_BIG_ENDIAN  (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#elif defined(__BYTE_ORDER) && defined(__BIG_ENDIAN)
+ #define __HOST_BIG_ENDIAN  (__BYTE_ORDER == __BIG_ENDIAN)
+#else
+ #error "unable to determine host byte order"
+#endif
 
-static void __write_be(void *buf, unsigned short val)
+/* 16 bit unit in @be order, safe for unaligned @p */
+static inline unsigned short __read16(const void *p, int be)
 {
-    if(__big_endian()) {
-        *(unsigned short *)buf = val;
-    } else {
-        unsigned char *a = (unsigned char *)buf;
+    uint16_t v;
 
-        *a = val >> 8;
-        *(a + 1) = val & 0x0F;
-    }
+    memcpy(&v, p, sizeof(v));
+    return be == __HOST_BIG_ENDIAN ? v : __builtin_bswap16(v);
 }
 
-static void __write_le(void *buf, unsigned short val)
+static inline void __write16(void *p, unsigned short val, int be)
 {
-    if(__big_endian()) {
-        unsigned char *a = buf;
+    uint16_t v = be == __HOST_BIG_ENDIAN ? val : __builtin_bswap16(val);
 
-        *a = val & 0x0F;
-        *(a + 1) = val >> 8;
-    } else {
-        *(unsigned short *)buf = val;
-    }
+    memcpy(p, &v, sizeof(v));
 }
 
-static int utf_encode_16(void (*write_short)(void *, unsigned short),
-                         void **buf, size_t *size, unsigned int cp)
+/* inlined with constant @be, no byte order test left at runtime */
+static inline int utf_encode_16(int be, void **buf, size_t *size, unsigned int cp)
 {
-    unsigned short *p = (unsigned short *)*buf;
-    size_t sz = 0;
-    int err = UTF_ERR_OK;
+    unsigned char *p = *buf;
 
     if(cp >= 0xD800 && cp <= 0xDFFF) /* fail if fall in UTF16 surrogates */
         return UTF_ERR_BAD_CODE;
 
-    do{
-        if(cp < 0x010000) {
-            if(*size < 2) {
-                err = UTF_ERR_SIZE;
-                break;
-            }
-
-            write_short(p, cp);
-            sz = 2;
-            break;
-        }
+    if(cp < 0x010000) {
+        if(*size < 2)
+            return UTF_ERR_SIZE;
 
-        if(cp > 0x10FFFF) {          /* currently UCS stops at 0x10FFFF */
-            err = UTF_ERR_BAD_CODE;
-            break;
-        }
+        __write16(p, cp, be);
+        *buf = p + 2;
+        *size -= 2;
+        return UTF_ERR_OK;
+    }
 
-        if(*size < 4) {
-            err = UTF_ERR_SIZE;
-            break;
-        }
+    if(cp > 0x10FFFF)           /* currently UCS stops at 0x10FFFF */
+        return UTF_ERR_BAD_CODE;
 
-        cp -= 0x010000;
-        write_short(p, cp >> 10);
-        write_short(p + 1, cp & 0x3FF);
-        sz = 4;
-        break;
-    }while (0);
+    if(*size < 4)
+        return UTF_ERR_SIZE;
 
-    *buf = (char *)*buf + sz;
-    *size -= sz;
-    return err;
+    cp -= 0x010000;
+    __write16(p, 0xD800 | (cp >> 10), be);
+    __write16(p + 2, 0xDC00 | (cp & 0x3FF), be);
+    *buf = p + 4;
+    *size -= 4;
+    return UTF_ERR_OK;
 }
 
 static int utf_encode_16be(void **buf, size_t *size, unsigned int cp)
 {
-    return utf_encode_16(__write_be, buf, size, cp);
+    return utf_encode_16(1, buf, size, cp);
 }
 
 static int utf_encode_16le(void **buf, size_t *size, unsigned int cp)
 {
-    return utf_encode_16(__write_le, buf, size, cp);
+    return utf_encode_16(0, buf, size, cp);
 }
 
-static int utf_decode_8(void **buf, size_t *size, unsigned int *cp)
+/*
+ * UTF8 lead byte classes, giving sequence length and the range of the
+ * second byte, which rules out overlongs, surrogates and > 0x10FFFF.
+ */
+static const unsigned char utf8_class[256] = {
+    [0xC2 ... 0xDF] = 1, [0xE0] = 2, [0xE1 ... 0xEC] = 3, [0xED] = 4,
+    [0xEE ... 0xEF] = 3, [0xF0] = 5, [0xF1 ... 0xF3] = 6, [0xF4] = 7,
+};
+
+static const struct {
+    unsigned char len, lo, hi;
+} utf8_lead[] = {
+    {0, 0, 0}, {2, 0x80, 0xBF}, {3, 0xA0, 0xBF}, {3, 0x80, 0xBF},
+    {3, 0x80, 0x9F}, {4, 0x90, 0xBF}, {4, 0x80, 0xBF}, {4, 0x80, 0x8F},
+};
+
+/*
+ * length of the UTF8 sequence at @p, 0 if cut short by @size, or minus
+ * the length of its maximal invalid subpart, which is what gets
+ * replaced by one substitute in lossy conversion.
+ */
+static inline int __utf8_seq(const unsigned char *p, size_t size)
 {
-    unsigned char *p = *buf;
-    size_t sz = 0;
-    int err = UTF_ERR_OK;
+    int c, n, i;
 
-    while(*size > 0) {
-        if(! (*p >> 7)) {       /* ascii code */
-            *cp = *p;
-            sz = 1;
-            break;
-        }
+    if(*p < 0x80)
+        return 1;
+
+    c = utf8_class[*p];
+    if(! (n = utf8_lead[c].len))
+        return -1;
+    if(size < 2)
+        return 0;
+    if(p[1] < utf8_lead[c].lo || p[1] > utf8_lead[c].hi)
+        return -1;
 
-#define __UTF8_ACCUM(_p)                                    \
-        if((*++(_p) >> 6) != 0x02) {  /* 10XXXXXX format */ \
-            err = UTF_ERR_BAD_CODE;                         \
-            break;                                          \
-        }                                                   \
-        *cp = (*cp << 6) | (*(_p) & 0x3F);
+    for(i = 2; i < n; i++) {
+        if((size_t)i >= size)
+            return 0;
+        if((p[i] & 0xC0) != 0x80) /* 10XXXXXX format */
+            return -i;
+    }
+    return n;
+}
 
-        if((*p >> 5) == 0x06) { /* 110XXXXX, 2 byte case */
-            if(*size < 2) {
-                err = UTF_ERR_INCOMPLETE;
-                break;
-            }
+static int utf_decode_8(void **buf, size_t *size, unsigned int *cp)
+{
+    const unsigned char *p = *buf;
+    int i, n;
 
-            *cp = *p & 0x1F;
+    if(! *size)
+        return UTF_ERR_OK;
 
-            __UTF8_ACCUM(p);
+    n = __utf8_seq(p, *size);
+    if(n < 0)                   /* also overlong, surrogates, > 0x10FFFF */
+        return UTF_ERR_BAD_CODE;
+    if(! n)
+        return UTF_ERR_INCOMPLETE;
 
-            sz = 2;
-            break;
-        } else if((*p >> 4) == 0x0E) { /* 1110XXXX, 3 byte case */
-            if(*size < 3) {
-                err = UTF_ERR_INCOMPLETE;
-                break;
-            }
+    *cp = n == 1 ? *p : *p & (0x7F >> n);
+    for(i = 1; i < n; i++)
+        *cp = (*cp << 6) | (p[i] & 0x3F);
 
-            *cp = *p & 0x0F;
+    *buf = (char *)*buf + n;
+    *size -= n;
+    return UTF_ERR_OK;
+}
 
-            __UTF8_ACCUM(p);
-            __UTF8_ACCUM(p);
+static inline int utf_decode_16(int be, void **buf, size_t *size, unsigned int *cp)
+{
+    const unsigned char *p = *buf;
+    unsigned short hi, lo;
 
-            sz = 3;
-            break;
-        } else if((*p >> 3) == 0xF0) { /* 11110XXX, 4 byte case */
-            if(*size < 4) {
-                err = UTF_ERR_INCOMPLETE;
-                break;
-            }
+    if(*size < 2)
+        return UTF_ERR_INCOMPLETE;
+
+    hi = __read16(p, be);
+    if(hi < 0xD800 || hi > 0xDFFF) { /* BMP plane */
+        *cp = hi;
+        *buf = (char *)*buf + 2;
+        *size -= 2;
+        return UTF_ERR_OK;
+    }
 
-            *cp = *p & 0x07;
+    /* UTF16/UCS16 extensions */
+    if(hi > 0xDBFF)             /* high surrogate expected */
+        return UTF_ERR_BAD_CODE;
 
-            __UTF8_ACCUM(p);
-            __UTF8_ACCUM(p);
-            __UTF8_ACCUM(p);
+    if(*size < 4)
+        return UTF_ERR_INCOMPLETE;
 
-            sz = 4;
-            break;
-        }
-#undef __UTF8_ACCUM
+    lo = __read16(p + 2, be);
+    if(lo < 0xDC00 || lo > 0xDFFF) /* low surrogate expected */
+        return UTF_ERR_BAD_CODE;
 
-        err = UTF_ERR_BAD_CODE;
-        break;
-    }
+    *cp = 0x010000 + ((hi - 0xD800) << 10) + (lo - 0xDC00);
+    *buf = (char *)*buf + 4;
+    *size -= 4;
+    return UTF_ERR_OK;
+}
 
-    /* skip surrogates reserved for UTF16, and check UCS tops */
-    if(err == UTF_ERR_OK &&
-       ((*cp >= 0xD800 && *cp <= 0xDFFF) || *cp > 0x10FFFF)) {
-        err = UTF_ERR_BAD_CODE;
-    } else {
-        *buf = (char *)*buf + sz;
-        *size -= sz;
-    }
-    return err;
+static int utf_decode_16be(void **buf, size_t *size, unsigned int *cp)
+{
+    return utf_decode_16(1, buf, size, cp);
 }
 
-static unsigned short __read_be(void *buf)
+static int utf_decode_16le(void **buf, size_t *size, unsigned int *cp)
 {
-    if(__big_endian())
-        return *(unsigned short *)buf;
+    return utf_decode_16(0, buf, size, cp);
+}
 
-    unsigned char *a = buf;
+static inline int __utf_sbcs(int coding)
+{
+    return coding >= UTF_CODING_LATIN1 && coding <= UTF_CODING_ASCII;
+}
 
-    return (*a << 8 | *(a + 1));
+/* code point of byte @c in single byte @coding, 0 if it has none */
+static inline unsigned int __sbcs_to_cp(int coding, unsigned char c)
+{
+    if(coding == UTF_CODING_LATIN1 || c < 0x80)
+        return c;
+    if(coding == UTF_CODING_ASCII)
+        return 0;
+    return c < 0xA0 ? cp1252_high[c - 0x80] : c;
 }
 
-static unsigned short __read_le(void *buf)
+/* byte of @cp in single byte @coding, -1 if it has none */
+static inline int __sbcs_from_cp(int coding, unsigned int cp)
 {
-    if(__big_endian()) {
-        unsigned char *a = buf;
+    unsigned int i;
 
-        return (*a | *(a + 1) << 8);
+    if(cp < 0x80)
+        return cp;
+    if(coding == UTF_CODING_LATIN1)
+        return cp < 0x100 ? (int)cp : -1;
+    if(coding == UTF_CODING_ASCII)
+        return -1;
+    if(cp >= 0xA0 && cp < 0x100)
+        return cp;
+    for(i = 0; i < ARRAYSIZE(cp1252_high); i++)  {
+        if(cp == cp1252_high[i])       /* cp >= 0x80, never a hole */
+            return 0x80 + i;
     }
+    return -1;
+}
 
-    return *(unsigned short *)buf;
+static inline int utf_encode_sbcs(int coding, void **buf, size_t *size, unsigned int cp)
+{
+    int c = __sbcs_from_cp(coding, cp);
+
+    if(c < 0)
+        return UTF_ERR_UNMAPPABLE;
+    if(*size < 1)
+        return UTF_ERR_SIZE;
+
+    *(unsigned char *)*buf = c;
+    *buf = (char *)*buf + 1;
+    *size -= 1;
+    return UTF_ERR_OK;
 }
 
-static int utf_decode_16(unsigned short (*read_short)(void *),
-                         void **buf, size_t *size, unsigned int *cp)
+static inline int utf_decode_sbcs(int coding, void **buf, size_t *size, unsigned int *cp)
 {
-    unsigned short _cp;
-    size_t sz = 0;
-    int err = UTF_ERR_OK;
+    const unsigned char *p = *buf;
 
-    if(*size < 2)
-        return UTF_ERR_BAD_CODE;
+    if(! *size)
+        return UTF_ERR_OK;
 
-    do{
-        _cp = read_short(*buf);
-        if(_cp < 0xD800 || _cp > 0xDFFF) { /* BMP plane */
-            *cp = _cp;
-            sz = 2;
-            break;
-        }
+    /* NUL is a code point of its own, not a missing one */
+    if(! (*cp = __sbcs_to_cp(coding, *p)) && *p)
+        return UTF_ERR_BAD_CODE;
 
-        /* UTF16/UCS16 extensions */
-        if(_cp > 0xDBFF) {       /* high surrogate expected */
-            err = UTF_ERR_BAD_CODE;
-            break;
-        }
-        *cp = (_cp - 0xD800) << 10;
+    *buf = (char *)*buf + 1;
+    *size -= 1;
+    return UTF_ERR_OK;
+}
 
-        if(_cp < 0xDC00) {       /* low surrogate expected */
-            err = UTF_ERR_BAD_CODE;
-            break;
-        }
-        *cp |= (_cp - 0xDC00);
+static int utf_encode_latin1(void **buf, size_t *size, unsigned int cp)
+{
+    return utf_encode_sbcs(UTF_CODING_LATIN1, buf, size, cp);
+}
 
-        *cp += 0x010000;
+static int utf_encode_cp1252(void **buf, size_t *size, unsigned int cp)
+{
+    return utf_encode_sbcs(UTF_CODING_CP1252, buf, size, cp);
+}
 
-        sz = 4;
-        break;
-    }while(0);
+static int utf_encode_ascii(void **buf, size_t *size, unsigned int cp)
+{
+    return utf_encode_sbcs(UTF_CODING_ASCII, buf, size, cp);
+}
 
-    *buf = (char *)*buf + sz;
-    *size -= sz;
-    return err;
+static int utf_decode_latin1(void **buf, size_t *size, unsigned int *cp)
+{
+    return utf_decode_sbcs(UTF_CODING_LATIN1, buf, size, cp);
 }
 
-static int utf_decode_16be(void **buf, size_t *size, unsigned int *cp)
+static int utf_decode_cp1252(void **buf, size_t *size, unsigned int *cp)
 {
-    return utf_decode_16(__read_be, buf, size, cp);
+    return utf_decode_sbcs(UTF_CODING_CP1252, buf, size, cp);
 }
 
-static int utf_decode_16le(void **buf, size_t *size, unsigned int *cp)
+static int utf_decode_ascii(void **buf, size_t *size, unsigned int *cp)
 {
-    return utf_decode_16(__read_le, buf, size, cp);
+    return utf_decode_sbcs(UTF_CODING_ASCII, buf, size, cp);
 }
 
-static int utf_do_convert(const utf_coding *from, void **in, size_t *in_sz,
-                          const utf_coding *to, void **out, size_t *out_sz)
+#define __SWAR_ONES  0x0101010101010101ULL
+#define __SWAR_HIGH  0x8080808080808080ULL
+
+#define __SWAR16_LOW8  0x00FF00FF00FF00FFULL
+#define __SWAR16_LOW15 0x7FFF7FFF7FFF7FFFULL
+
+/* swap the two bytes of every 16 bit lane */
+static inline uint64_t __swab16x4(uint64_t w)
 {
-    unsigned int code_point;
-    int err;
+    return ((w & __SWAR16_LOW8) << 8) | ((w >> 8) & __SWAR16_LOW8);
+}
 
-    if(! in || ! in_sz || ! out || ! out_sz)
-        return UTF_ERR_BAD_ARG;
+/* bit 15 of every 16 bit lane of @w whose top 6 bits match @tag */
+static inline uint64_t __lanes16x4(uint64_t w, uint64_t tag)
+{
+    w = (w & 0xFC00FC00FC00FC00ULL) ^ tag;
+    return ~(((w & __SWAR16_LOW15) + __SWAR16_LOW15) | w | __SWAR16_LOW15);
+}
 
-    while(*in_sz > 0) {
-        if((err = from->decode(in, in_sz, &code_point)))
-            break;
-        if((err = to->encode(out, out_sz, code_point)))
-            break;
-    }
+/*
+ * true if every surrogate of host order @w is part of a pair held in
+ * @w, i.e. each high surrogate lane is followed by a low one.
+ */
+static inline int __paired16x4(uint64_t w)
+{
+    uint64_t hs = __lanes16x4(w, 0xD800D800D800D800ULL);
+    uint64_t ls = __lanes16x4(w, 0xDC00DC00DC00DC00ULL);
 
-    return err;
+#if __HOST_BIG_ENDIAN
+    return (hs >> 16) == ls && ! (hs & 0x8000);
+#else
+    return (hs << 16) == ls && ! (hs >> 63);
+#endif
 }
 
-static const utf_coding *utf_coding_get(int coding, const char *name)
+/*
+ * UTF16BE <-> UTF16LE is a byte swap of every unit, no need to go
+ * through code points. blocks are swapped 16 or 8 bytes at a time
+ * when @validate is off or all their surrogates are paired within the
+ * block, the rest go one unit at a time. on error *in and *out stop
+ * at the offending unit. @in and @out may be the same buffer.
+ */
+static int utf16_swap(int be, void **in, size_t *in_sz,
+                      void **out, size_t *out_sz, int validate)
 {
-    unsigned int i;
+    const unsigned char *s = *in;
+    unsigned char *d = *out;
+    size_t n = (*in_sz < *out_sz ? *in_sz : *out_sz) & ~(size_t)1;
+    size_t i = 0;
+    int native = (be == __HOST_BIG_ENDIAN);
+    unsigned short u;
+    int step;
+    uint64_t w, sw;
+    int err = UTF_ERR_OK;
 
-    if(coding != UTF_CODING_INVALID) {
-        for(i = 0; i < ARRAYSIZE(utf_coding_table); i++) {
-            if(coding == utf_coding_table[i].coding) {
-                return &utf_coding_table[i];
+    while(i + 2 <= n) {
+#ifdef __SSE2__
+        if(i + 16 <= n) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+            __m128i sv = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            __m128i h = _mm_and_si128(native ? v : sv, _mm_set1_epi16((short)0xFC00));
+            int hs = _mm_movemask_epi8(_mm_cmpeq_epi16(h, _mm_set1_epi16((short)0xD800)));
+            int ls = _mm_movemask_epi8(_mm_cmpeq_epi16(h, _mm_set1_epi16((short)0xDC00)));
+
+            /* 2 mask bits per lane, same pairing rule as __paired16x4() */
+            if(! validate || (((hs << 2) & 0xFFFF) == ls && ! (hs & 0xC000))) {
+                _mm_storeu_si128((__m128i *)(d + i), sv);
+                i += 16;
+                continue;
+            }
+        }
+#endif
+        if(i + 8 <= n) {
+            memcpy(&w, s + i, 8);
+            sw = __swab16x4(w);
+            if(! validate || __paired16x4(native ? w : sw)) {
+                memcpy(d + i, &sw, 8);
+                i += 8;
+                continue;
             }
         }
-    }
 
-    if(name && name[0]) {
-        for(i = 0; i < ARRAYSIZE(utf_coding_table); i++) {
-            if(! strcasecmp(name, utf_coding_table[i].name)) {
-                return &utf_coding_table[i];
+        u = __read16(s + i, be);
+        step = 2;
+        if(validate && u >= 0xD800 && u <= 0xDFFF) {
+            if(u > 0xDBFF) {    /* high surrogate expected */
+                err = UTF_ERR_BAD_CODE;
+                break;
+            }
+            if(i + 4 > n) {
+                err = (i + 4 > *in_sz) ? UTF_ERR_INCOMPLETE : UTF_ERR_SIZE;
+                break;
+            }
+            u = __read16(s + i + 2, be);
+            if(u < 0xDC00 || u > 0xDFFF) { /* low surrogate expected */
+                err = UTF_ERR_BAD_CODE;
+                break;
             }
+            step = 4;
+        }
+        for(; step > 0; step -= 2, i += 2)  {
+            u = s[i];
+            d[i] = s[i + 1];
+            d[i + 1] = u;
         }
     }
 
-    return NULL;
+    if(err == UTF_ERR_OK && i < *in_sz)
+        err = (*in_sz - i < 2) ? UTF_ERR_INCOMPLETE : UTF_ERR_SIZE;
+
+    *in = (char *)*in + i;
+    *in_sz -= i;
+    *out = (char *)*out + i;
+    *out_sz -= i;
+    return err;
 }
 
-int tiny_utf_convert(int from, void **in, size_t *in_sz,
-                     int to, void **out, size_t *out_sz)
+static inline int __utf16_swapped(int from, int to)
 {
-    const utf_coding *fcoding = utf_coding_get(from, NULL);
-    const utf_coding *tcoding = utf_coding_get(to, NULL);
+    return from != to &&
+        (from == UTF_CODING_UTF16BE || from == UTF_CODING_UTF16LE) &&
+        (to == UTF_CODING_UTF16BE || to == UTF_CODING_UTF16LE);
+}
+
+/*
+ * single byte @from to UTF8 or UTF16 @to without a call per code
+ * point: 16 or 8 bytes at a time while they are ASCII, any LATIN1
+ * block to UTF16 as it is a zero extension, a byte at a time
+ * otherwise. stops at an undefined byte or a full output, left for
+ * the per code point path to report.
+ */
+static void sbcs_widen(int from, int to, void **in, size_t *in_sz,
+                       void **out, size_t *out_sz)
+{
+    const unsigned char *s = *in, *end = s + *in_sz, *run;
+    unsigned char *d = *out, *dend = d + *out_sz;
+    size_t unit = (to == UTF_CODING_UTF8) ? 1 : 2;
+    int be = (to == UTF_CODING_UTF16BE);
+    int zext = (unit == 2 && from == UTF_CODING_LATIN1);
+    unsigned int cp, hi;
+    uint64_t w;
+    int i;
+
+    while(s < end) {
+#ifdef __SSE2__
+        if(end - s >= 16 && (size_t)(dend - d) >= 16 * unit) {
+            __m128i v = _mm_loadu_si128((const __m128i *)s);
+            __m128i z = _mm_setzero_si128();
+
+            if(zext || ! _mm_movemask_epi8(v)) {
+                if(unit == 1) {
+                    _mm_storeu_si128((__m128i *)d, v);
+                } else {
+                    _mm_storeu_si128((__m128i *)d, be ? _mm_unpacklo_epi8(z, v) : _mm_unpacklo_epi8(v, z));
+                    _mm_storeu_si128((__m128i *)(d + 16), be ? _mm_unpackhi_epi8(z, v) : _mm_unpackhi_epi8(v, z));
+                }
+                s += 16;
+                d += 16 * unit;
+                continue;
+            }
+        }
+#endif
+        if(end - s >= 8 && (size_t)(dend - d) >= 8 * unit) {
+            memcpy(&w, s, 8);
+            if(zext || ! (w & __SWAR_HIGH)) {
+                if(unit == 1)
+                    memcpy(d, &w, 8);
+                else
+                    for(i = 0; i < 8; i++)
+                        __write16(d + i * 2, s[i], be);
+                s += 8;
+                d += 8 * unit;
+                continue;
+            }
+        }
+
+        /* the block failed, its bytes go one at a time before a retry */
+        run = (end - s > 16) ? s + 16 : end;
+        if(unit == 1 && from == UTF_CODING_LATIN1 && dend - d >= 2 * (run - s)) {
+            /* 1 or 2 bytes each, no branch on which */
+            for(; s < run; s++) {
+                hi = 0 - (*s >> 7);
+                d[0] = (*s & ~hi) | ((0xC0 | (*s >> 6)) & hi);
+                d[1] = 0x80 | (*s & 0x3F);
+                d += 1 + (*s >> 7);
+            }
+            continue;
+        }
+        for(; s < run; s++) {
+            if(! (cp = __sbcs_to_cp(from, *s)) && *s)
+                break;
+            if(unit == 2) {
+                if(dend - d < 2)
+                    break;
+                __write16(d, cp, be);
+                d += 2;
+            } else if(cp < 0x80) {
+                if(d == dend)
+                    break;
+                *d++ = cp;
+            } else if(cp < 0x800) {
+                if(dend - d < 2)
+                    break;
+                d[0] = 0xC0 | (cp >> 6);
+                d[1] = 0x80 | (cp & 0x3F);
+                d += 2;
+            } else {            /* CP1252 stays in the BMP */
+                if(dend - d < 3)
+                    break;
+                d[0] = 0xE0 | (cp >> 12);
+                d[1] = 0x80 | ((cp >> 6) & 0x3F);
+                d[2] = 0x80 | (cp & 0x3F);
+                d += 3;
+            }
+        }
+        if(s < run)
+            break;
+    }
+
+    *in_sz -= s - (const unsigned char *)*in;
+    *out_sz -= d - (unsigned char *)*out;
+    *in = (void *)s;
+    *out = d;
+}
+
+/*
+ * UTF8 or UTF16 @from to single byte @to, the other way round: ASCII
+ * 16 or 8 units at a time, UTF16 below U+0100 packed down for LATIN1,
+ * 2 byte UTF8 LATIN1 letters one at a time. anything else, bad input
+ * included, is left to the per code point path.
+ */
+static void sbcs_narrow(int from, int to, void **in, size_t *in_sz,
+                        void **out, size_t *out_sz)
+{
+    const unsigned char *s = *in, *end = s + *in_sz;
+    unsigned char *d = *out, *dend = d + *out_sz;
+    unsigned int lim = (to == UTF_CODING_LATIN1) ? 0x100 : 0x80;
+    int be = (from == UTF_CODING_UTF16BE);
+    unsigned short u;
+    uint64_t w;
+
+    if(from == UTF_CODING_UTF8) {
+        while(s < end && d < dend) {
+#ifdef __SSE2__
+            if(end - s >= 16 && dend - d >= 16) {
+                __m128i v = _mm_loadu_si128((const __m128i *)s);
+
+                if(! _mm_movemask_epi8(v)) {
+                    _mm_storeu_si128((__m128i *)d, v);
+                    s += 16;
+                    d += 16;
+                    continue;
+                }
+            }
+#endif
+            if(end - s >= 8 && dend - d >= 8) {
+                memcpy(&w, s, 8);
+                if(! (w & __SWAR_HIGH)) {
+                    memcpy(d, &w, 8);
+                    s += 8;
+                    d += 8;
+                    continue;
+                }
+            }
+
+            if(*s < 0x80) {
+                *d++ = *s++;
+            } else if(lim == 0x100 && (*s & 0xFE) == 0xC2 &&
+                      end - s >= 2 && (s[1] & 0xC0) == 0x80) {
+                *d++ = ((*s & 0x1F) << 6) | (s[1] & 0x3F);
+                s += 2;
+            } else {
+                break;
+            }
+        }
+    } else {
+        while(end - s >= 2 && d < dend) {
+#ifdef __SSE2__
+            if(end - s >= 16 && dend - d >= 8) {
+                __m128i v = _mm_loadu_si128((const __m128i *)s);
+                __m128i hi = _mm_set1_epi16((short)(0x10000 - lim));
+
+                if(be)
+                    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, hi), _mm_setzero_si128())) == 0xFFFF) {
+                    _mm_storel_epi64((__m128i *)d, _mm_packus_epi16(v, v));
+                    s += 16;
+                    d += 8;
+                    continue;
+                }
+            }
+#endif
+            u = __read16(s, be);
+            if(u >= lim)
+                break;
+            *d++ = u;
+            s += 2;
+        }
+    }
+
+    *in_sz -= s - (const unsigned char *)*in;
+    *out_sz -= d - (unsigned char *)*out;
+    *in = (void *)s;
+    *out = d;
+}
+
+/* bytes of the invalid sequence at @p which one substitute replaces */
+static size_t utf_bad_len(int coding, const void *p, size_t size)
+{
+    if(coding == UTF_CODING_UTF8)
+        return -__utf8_seq((const unsigned char *)p, size);
+    if(__utf_sbcs(coding))
+        return 1;
+    return 2;                   /* a lone surrogate */
+}
+
+/*
+ * with UTF_CONV_REPLACE in @flags, invalid input is replaced by @subst
+ * in the same pass and counted into *@nsubst. input cut short at the
+ * end is still UTF_ERR_INCOMPLETE, more may follow.
+ */
+static int utf_do_convert(const utf_coding *from, void **in, size_t *in_sz,
+                          const utf_coding *to, void **out, size_t *out_sz,
+                          int flags, unsigned int subst, size_t *nsubst)
+{
+    unsigned int code_point;
+    size_t isz, osz, bad = 0, cnt = 0;
+    int err = UTF_ERR_OK;
+    STAT_BEGIN(t);
+
+    if(! in || ! in_sz || ! out || ! out_sz)
+        return UTF_ERR_BAD_ARG;
+
+    isz = *in_sz;
+    osz = *out_sz;
+    if(__utf16_swapped(from->coding, to->coding)) {
+        while((err = utf16_swap(from->coding == UTF_CODING_UTF16BE, in, in_sz, out, out_sz, 1))
+              == UTF_ERR_BAD_CODE && (flags & UTF_CONV_REPLACE)) {
+            if((err = to->encode(out, out_sz, subst)))
+                break;
+            *in = (char *)*in + 2;
+            *in_sz -= 2;
+            cnt++;
+        }
+    } else {
+        /* between a single byte coding and UTF, runs go in bulk */
+        int bulk = __utf_sbcs(from->coding) != __utf_sbcs(to->coding);
+
+        while(*in_sz > 0) {
+            void *_in;
+            size_t _in_sz;
+
+            if(bulk) {
+                if(__utf_sbcs(from->coding))
+                    sbcs_widen(from->coding, to->coding, in, in_sz, out, out_sz);
+                else
+                    sbcs_narrow(from->coding, to->coding, in, in_sz, out, out_sz);
+                if(! *in_sz)
+                    break;
+            }
+
+            _in = *in;
+            _in_sz = *in_sz;
+            if((err = from->decode(in, in_sz, &code_point))) {
+                if(err != UTF_ERR_BAD_CODE || ! (flags & UTF_CONV_REPLACE))
+                    break;
+                bad = utf_bad_len(from->coding, *in, *in_sz);
+                code_point = subst;
+            }
+            err = to->encode(out, out_sz, code_point);
+            if(err == UTF_ERR_UNMAPPABLE && (flags & UTF_CONV_REPLACE)) {
+                /* @subst itself may be missing from a single byte coding */
+                if((err = to->encode(out, out_sz, subst)) == UTF_ERR_UNMAPPABLE)
+                    err = to->encode(out, out_sz, '?');
+                if(! err && ! bad)
+                    cnt++;
+            }
+            if(err) {
+                /* leave the code point to be retried */
+                *in = _in;
+                *in_sz = _in_sz;
+                break;
+            }
+            if(bad) {
+                *in = (char *)*in + bad;
+                *in_sz -= bad;
+                bad = 0;
+                cnt++;
+            }
+        }
+    }
+
+    if(nsubst)
+        *nsubst = cnt;
+    STAT_END(TINY_STAT_UTF_CONVERT, t, isz - *in_sz, osz - *out_sz);
+    STAT_ERROR(err);
+    return err;
+}
+
+static const utf_coding *utf_coding_get(int coding, const char *name)
+{
+    unsigned int i;
+
+    if(coding != UTF_CODING_INVALID) {
+        for(i = 0; i < ARRAYSIZE(utf_coding_table); i++) {
+            if(coding == utf_coding_table[i].coding) {
+                return &utf_coding_table[i];
+            }
+        }
+    }
+
+    if(name && name[0]) {
+        for(i = 0; i < ARRAYSIZE(utf_coding_table); i++) {
+            if(! strcasecmp(name, utf_coding_table[i].name)) {
+                return &utf_coding_table[i];
+            }
+        }
+        for(i = 0; i < ARRAYSIZE(utf_coding_alias); i++) {
+            if(! strcasecmp(name, utf_coding_alias[i].name)) {
+                return utf_coding_get(utf_coding_alias[i].coding, NULL);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+int tiny_utf_coding_id(const char *name)
+{
+    const utf_coding *coding = utf_coding_get(UTF_CODING_INVALID, name);
+
+    return coding ? coding->coding : UTF_CODING_INVALID;
+}
+
+int tiny_utf_convert(int from, void **in, size_t *in_sz,
+                     int to, void **out, size_t *out_sz)
+{
+    const utf_coding *fcoding = utf_coding_get(from, NULL);
+    const utf_coding *tcoding = utf_coding_get(to, NULL);
+
+    if(! fcoding || ! tcoding)
+        return UTF_ERR_NO_SUPPORT;
+
+    return utf_do_convert(fcoding, in, in_sz, tcoding, out, out_sz, 0, 0, NULL);
+}
+
+/*
+ * tiny_utf_convert() replacing invalid input with @subst, U+FFFD if 0,
+ * when @flags has UTF_CONV_REPLACE, *@nsubst gets the replacements.
+ */
+int tiny_utf_convert_ex(int from, void **in, size_t *in_sz,
+                        int to, void **out, size_t *out_sz,
+                        int flags, unsigned int subst, size_t *nsubst)
+{
+    const utf_coding *fcoding = utf_coding_get(from, NULL);
+    const utf_coding *tcoding = utf_coding_get(to, NULL);
 
     if(! fcoding || ! tcoding)
         return UTF_ERR_NO_SUPPORT;
 
-    return utf_do_convert(fcoding, in, in_sz, tcoding, out, out_sz);
+    if(! subst)
+        subst = UTF_REPLACEMENT_CHAR;
+    if(subst > 0x10FFFF || (subst >= 0xD800 && subst <= 0xDFFF))
+        return UTF_ERR_BAD_ARG;
+
+    return utf_do_convert(fcoding, in, in_sz, tcoding, out, out_sz, flags, subst, nsubst);
+}
+
+int tiny_utf_convert_name(const char *from, void **in, size_t *in_sz,
+                          const char *to, void **out, size_t *out_sz)
+{
+    const utf_coding *fcoding = utf_coding_get(UTF_CODING_INVALID, from);
+    const utf_coding *tcoding = utf_coding_get(UTF_CODING_INVALID, to);
+
+    if(! fcoding || ! tcoding)
+        return UTF_ERR_NO_SUPPORT;
+
+    return utf_do_convert(fcoding, in, in_sz, tcoding, out, out_sz, 0, 0, NULL);
+}
+
+/*
+ * byte swap UTF16 text from @from order to the other one, surrogate
+ * pairs are checked only if @validate. same contract as
+ * tiny_utf_convert(), @in and @out may be the same buffer.
+ */
+int tiny_utf16_swap(int from, void **in, size_t *in_sz,
+                    void **out, size_t *out_sz, int validate)
+{
+    size_t isz;
+    int err;
+    STAT_BEGIN(t);
+
+    if(! in || ! in_sz || ! out || ! out_sz)
+        return UTF_ERR_BAD_ARG;
+
+    if(from != UTF_CODING_UTF16BE && from != UTF_CODING_UTF16LE)
+        return UTF_ERR_NO_SUPPORT;
+
+    isz = *in_sz;
+    err = utf16_swap(from == UTF_CODING_UTF16BE, in, in_sz, out, out_sz, validate);
+    STAT_END(TINY_STAT_UTF_CONVERT, t, isz - *in_sz, isz - *in_sz);
+    STAT_ERROR(err);
+    return err;
+}
+
+/* counters gathered by tiny_utf_detect() in its single pass */
+struct utf_sniff {
+    size_t zeros[2];            /* zero bytes at even/odd offsets */
+    size_t ctrl[2];             /* other bytes below 0x20 */
+    size_t strict;              /* of them all, neither \t \n \v \f nor \r */
+    size_t unpaired[2];         /* unpaired surrogates as UTF16BE/LE */
+    uint64_t carry[2];
+    uint64_t high;              /* any byte above 0x7F */
+    size_t pos;                 /* UTF8 validated up to */
+    int bad8;                   /* not valid UTF8 */
+};
+
+/* validate UTF8 from sn->pos to at least @end, a sequence cut by @len is fine */
+static void __sniff_utf8(struct utf_sniff *sn, const unsigned char *p, size_t len, size_t end)
+{
+    size_t i = sn->pos;
+    int n;
+
+    while(i < end) {
+        if(p[i] < 0x80) {
+            i++;
+            continue;
+        }
+
+        if((n = __utf8_seq(p + i, len - i)) < 0) {
+            sn->bad8 = 1;
+            return;
+        }
+        if(! n) {
+            i = len;
+            break;
+        }
+        i += n;
+    }
+    sn->pos = i;
+}
+
+/* surrogates of host order @w not paired, pairs may span words via @carry */
+static inline int __unpaired16x4(uint64_t w, uint64_t *carry)
+{
+    uint64_t hs = __lanes16x4(w, 0xD800D800D800D800ULL);
+    uint64_t ls = __lanes16x4(w, 0xDC00DC00DC00DC00ULL);
+    uint64_t want;
+
+#if __HOST_BIG_ENDIAN
+    want = (hs >> 16) | *carry;
+    *carry = (hs & 0x8000) << 48;
+#else
+    want = (hs << 16) | *carry;
+    *carry = hs >> 48;
+#endif
+    want ^= ls;
+    return want ? __builtin_popcountll(want) : 0;
+}
+
+/* high bit of every byte of @w below @n, exact as (b | 0x80) - @n never borrows */
+static inline uint64_t __below8x8(uint64_t w, unsigned char n)
+{
+    return ~((w | __SWAR_HIGH) - n * __SWAR_ONES) & ~w & __SWAR_HIGH;
+}
+
+/* sum of the low bytes of every 16 bit lane of @v */
+static inline size_t __hsum8x4(uint64_t v)
+{
+    return ((v & __SWAR16_LOW8) * 0x0001000100010001ULL) >> 48;
+}
+
+/* even offset bytes are the low byte of a 16 bit lane on little endian */
+static inline size_t __sum_even8x8(uint64_t acc)
+{
+    return __hsum8x4(__HOST_BIG_ENDIAN ? acc >> 8 : acc);
+}
+
+static inline size_t __sum_odd8x8(uint64_t acc)
+{
+    return __hsum8x4(__HOST_BIG_ENDIAN ? acc : acc >> 8);
+}
+
+/*
+ * guess the coding of @buf without converting it. a BOM wins, else
+ * one pass counts control bytes per offset parity, UTF8 errors and
+ * unpaired UTF16 surrogates in both byte orders. *@confidence gets
+ * 0..100, *@bom the length of the BOM to skip, both may be NULL.
+ */
+int tiny_utf_detect(const void *buf, size_t len, int *confidence, size_t *bom)
+{
+    const unsigned char *p = buf;
+    struct utf_sniff sn;
+    size_t i, units;
+    long score[2], margin;
+    uint64_t w, zb, lb, ws, acc[3];
+    int k, coding, conf;
+
+    if(bom)
+        *bom = 0;
+
+    if(len >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) {
+        coding = UTF_CODING_UTF8;
+        conf = 100;
+        if(bom)
+            *bom = 3;
+        goto out;
+    }
+    if(len >= 2 && ((p[0] == 0xFE && p[1] == 0xFF) || (p[0] == 0xFF && p[1] == 0xFE))) {
+        coding = p[0] == 0xFE ? UTF_CODING_UTF16BE : UTF_CODING_UTF16LE;
+        conf = 100;
+        if(bom)
+            *bom = 2;
+        goto out;
+    }
+
+    memset(&sn, 0, sizeof(sn));
+    for(i = 0; i + 8 <= len;) {
+        /* per byte counters of zeros, controls and strict controls */
+        acc[0] = acc[1] = acc[2] = 0;
+        for(k = 0; k < 255 && i + 8 <= len; k++, i += 8) {
+            memcpy(&w, p + i, 8);
+            zb = __below8x8(w, 0x01);
+            lb = __below8x8(w, 0x20);
+            ws = __below8x8(w, 0x0E) & ~__below8x8(w, 0x09);
+            acc[0] += zb >> 7;
+            acc[1] += (lb & ~zb) >> 7;
+            acc[2] += (lb & ~ws) >> 7;
+            sn.unpaired[0] += __unpaired16x4(__HOST_BIG_ENDIAN ? w : __swab16x4(w), &sn.carry[0]);
+            sn.unpaired[1] += __unpaired16x4(__HOST_BIG_ENDIAN ? __swab16x4(w) : w, &sn.carry[1]);
+            /* ascii words can not break UTF8, any sequence ending in them is checked */
+            if(w & __SWAR_HIGH) {
+                sn.high = 1;
+                if(! sn.bad8 && sn.pos < i + 8)
+                    __sniff_utf8(&sn, p, len, i + 8);
+            } else if(sn.pos < i + 8) {
+                sn.pos = i + 8;
+            }
+        }
+        sn.zeros[0] += __sum_even8x8(acc[0]);
+        sn.zeros[1] += __sum_odd8x8(acc[0]);
+        sn.ctrl[0] += __sum_even8x8(acc[1]);
+        sn.ctrl[1] += __sum_odd8x8(acc[1]);
+        sn.strict += __sum_even8x8(acc[2]) + __sum_odd8x8(acc[2]);
+    }
+    for(; i < len; i++) {
+        sn.zeros[i & 1] += ! p[i];
+        sn.ctrl[i & 1] += p[i] && p[i] < 0x20;
+        sn.strict += p[i] < 0x09 || (p[i] >= 0x0E && p[i] < 0x20);
+        sn.high |= p[i] & 0x80;
+    }
+    if(! sn.bad8)
+        __sniff_utf8(&sn, p, len, len);
+
+    /*
+     * the high byte of latin, greek, cyrillic, arabic, indic, thai...
+     * in UTF16 is below 0x20, zero for ascii. in UTF8 text such bytes
+     * are whitespace at most.
+     */
+    if(! sn.bad8 && (sn.high || ! sn.strict)) {
+        /*
+         * UTF16 hardly ever makes valid UTF8 multi byte sequences,
+         * plain ascii could be anything but is rarely UTF16.
+         */
+        coding = UTF_CODING_UTF8;
+        conf = ! len ? 0 : ! sn.high ? 80 : sn.strict ? 90 : 95;
+        goto out;
+    }
+
+    /*
+     * score each byte order by the bytes it takes as high bytes, taken
+     * in the wrong order the low bytes of e.g. CJK make random
+     * unpaired surrogates.
+     */
+    for(i = 0; i < 2; i++)
+        score[i] = (long)(2 * sn.zeros[i] + sn.ctrl[i]) - 8 * (long)sn.unpaired[i];
+    coding = score[0] >= score[1] ? UTF_CODING_UTF16BE : UTF_CODING_UTF16LE;
+    margin = score[0] >= score[1] ? score[0] - score[1] : score[1] - score[0];
+    units = len / 2 ? len / 2 : 1;
+    conf = 50 + 49 * (margin < (long)units ? margin : (long)units) / units;
+
+    if(! sn.bad8 && conf < 70) {
+        /* not convincing enough to reject valid UTF8 */
+        coding = UTF_CODING_UTF8;
+        conf = 50;
+    }
+
+ out:
+    if(confidence)
+        *confidence = conf;
+    return coding;
+}
+
+/* UTF8 continuation bytes, 10XXXXXX, in @p[0, n) */
+static size_t __utf8_cont(const unsigned char *p, size_t n)
+{
+    size_t cont = 0;
+    uint64_t w, acc;
+    int k;
+
+#ifdef __SSE2__
+    while(n >= 16) {
+        __m128i sum = _mm_setzero_si128();
+
+        /* 0x80..0xBF are the signed bytes below -0x40, count per lane */
+        for(k = 0; k < 255 && n >= 16; k++, p += 16, n -= 16)
+            sum = _mm_sub_epi8(sum, _mm_cmplt_epi8(_mm_loadu_si128((const __m128i *)p),
+                                                   _mm_set1_epi8(-0x40)));
+        sum = _mm_sad_epu8(sum, _mm_setzero_si128());
+        cont += _mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4);
+    }
+#endif
+    while(n >= 8) {
+        for(acc = 0, k = 0; k < 255 && n >= 8; k++, p += 8, n -= 8) {
+            memcpy(&w, p, 8);
+            acc += (w & ~(w << 1) & __SWAR_HIGH) >> 7;
+        }
+        cont += __hsum8x4(acc) + __hsum8x4(acc >> 8);
+    }
+    for(; n > 0; n--, p++)
+        cont += (*p & 0xC0) == 0x80;
+    return cont;
+}
+
+/*
+ * code points in UTF8 @text, i.e. bytes other than continuation bytes.
+ * invalid bytes count as one code point each.
+ */
+size_t tiny_utf8_count(const char *text, size_t len)
+{
+    return len - __utf8_cont((const unsigned char *)text, len);
+}
+
+#define UTF8_SKIP_CHUNK  64
+
+/*
+ * byte offset of code point @k of @text, @len if there are no more than
+ * @k, which is also the length of @text truncated to @k code points.
+ */
+size_t tiny_utf8_skip(const char *text, size_t len, size_t k)
+{
+    const unsigned char *p = (const unsigned char *)text;
+    size_t i = 0, n;
+
+    /* whole chunks holding no more than @k code points first */
+    while(i + UTF8_SKIP_CHUNK <= len &&
+          (n = UTF8_SKIP_CHUNK - __utf8_cont(p + i, UTF8_SKIP_CHUNK)) <= k) {
+        k -= n;
+        i += UTF8_SKIP_CHUNK;
+    }
+
+    for(; i < len; i++) {
+        if((p[i] & 0xC0) != 0x80 && ! k--)
+            return i;
+    }
+    return len;
+}
+
+/*
+ * count code points of @text and sample the byte offset of every
+ * @stride one in the same pass. @text must outlive the index, free()
+ * the index when done.
+ */
+struct tiny_utf8_index *tiny_utf8_index_new(const char *text, size_t len, unsigned int stride)
+{
+    const unsigned char *p = (const unsigned char *)text;
+    struct tiny_utf8_index *idx, *tmp;
+    size_t i, n, cnt = 0, mark = 0;
+
+    if(! stride)
+        return NULL;
+
+    /* no more code points than bytes */
+    idx = (struct tiny_utf8_index *)malloc(sizeof(*idx) + (len / stride + 1) * sizeof(size_t));
+    if(! idx)  {
+        printf("OOM indexing UTF8 text!\n");
+        return NULL;
+    }
+
+    idx->off = (size_t *)(idx + 1);
+    idx->text = text;
+    idx->len = len;
+    idx->stride = stride;
+    idx->nr = 0;
+    for(i = 0; i + UTF8_SKIP_CHUNK <= len; i += UTF8_SKIP_CHUNK)  {
+        n = UTF8_SKIP_CHUNK - __utf8_cont(p + i, UTF8_SKIP_CHUNK);
+        for(; mark < cnt + n; mark += stride)
+            idx->off[idx->nr++] = i + tiny_utf8_skip(text + i, UTF8_SKIP_CHUNK, mark - cnt);
+        cnt += n;
+    }
+    for(; i < len; i++)  {
+        if((p[i] & 0xC0) == 0x80)
+            continue;
+        if(cnt++ == mark)  {
+            idx->off[idx->nr++] = i;
+            mark += stride;
+        }
+    }
+    idx->count = cnt;
+
+    if((tmp = realloc(idx, sizeof(*idx) + idx->nr * sizeof(size_t))))
+        idx = tmp;
+    idx->off = (size_t *)(idx + 1);
+    return idx;
+}
+
+/* byte offset of code point @k, skipping at most @stride - 1 from a sample */
+size_t tiny_utf8_index_offset(const struct tiny_utf8_index *idx, size_t k)
+{
+    size_t off;
+
+    if(k >= idx->count)
+        return idx->len;
+
+    off = idx->off[k / idx->stride];
+    return off + tiny_utf8_skip(idx->text + off, idx->len - off, k % idx->stride);
+}
+
+/*
+ * worker pool for parallel conversion, started on first use with one
+ * worker per online cpu but the caller, which joins in running jobs.
+ * one job at a time, a caller finding the pool busy runs serially.
+ * tiny_utf_parallel_shutdown() joins the workers, the next job starts
+ * them again.
+ */
+#ifndef TINYCODE_NO_PARALLEL
+struct pool_job {
+    void (*fn)(void *arg, int idx);
+    void *arg;
+    int count;
+    int next;
+    int done;
+    int refs;                   /* workers holding the job, under lock */
+};
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_mutex_t busy;       /* held by the running job and by start/stop */
+    pthread_cond_t cond;
+    pthread_cond_t done;
+    struct pool_job *job;
+    unsigned long gen;
+    pthread_t *tids;
+    int workers;
+    int started;
+    int quit;
+} pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+};
+
+static void __pool_run(struct pool_job *job)
+{
+    int idx;
+
+    while((idx = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->count)  {
+        job->fn(job->arg, idx);
+        if(__atomic_add_fetch(&job->done, 1, __ATOMIC_ACQ_REL) == job->count)  {
+            pthread_mutex_lock(&pool.lock);
+            pthread_cond_broadcast(&pool.done);
+            pthread_mutex_unlock(&pool.lock);
+        }
+    }
+}
+
+static void *__pool_worker(void *arg)
+{
+    struct pool_job *job;
+    unsigned long gen = 0;
+
+    for(;;)  {
+        pthread_mutex_lock(&pool.lock);
+        while(pool.gen == gen && ! pool.quit)
+            pthread_cond_wait(&pool.cond, &pool.lock);
+        if(pool.quit)  {
+            pthread_mutex_unlock(&pool.lock);
+            break;
+        }
+        gen = pool.gen;
+        if((job = pool.job))
+            job->refs++;
+        pthread_mutex_unlock(&pool.lock);
+
+        if(job)  {
+            __pool_run(job);
+            pthread_mutex_lock(&pool.lock);
+            if(! --job->refs)
+                pthread_cond_broadcast(&pool.done);
+            pthread_mutex_unlock(&pool.lock);
+        }
+    }
+    return NULL;
+}
+
+/* with pool.busy held */
+static void __pool_start(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    pool.started = 1;
+    if(n < 2 || ! (pool.tids = (pthread_t *)malloc((n - 1) * sizeof(pthread_t))))
+        return;
+    for(; n > 1; n--)  {
+        if(pthread_create(&pool.tids[pool.workers], NULL, __pool_worker, NULL))
+            break;
+        pool.workers++;
+    }
+}
+
+/* run fn(arg, 0..count-1) across the pool, returns once all done */
+static void pool_run(void (*fn)(void *, int), void *arg, int count)
+{
+    struct pool_job job = {fn, arg, count, 0, 0, 0};
+    int idx;
+
+    if(pthread_mutex_trylock(&pool.busy))
+        goto serial;
+    if(! pool.started)
+        __pool_start();
+    if(! pool.workers)  {
+        pthread_mutex_unlock(&pool.busy);
+        goto serial;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job = &job;
+    pool.gen++;
+    pthread_cond_broadcast(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+
+    __pool_run(&job);
+
+    /* job lives on our stack, wait for every worker to let go of it */
+    pthread_mutex_lock(&pool.lock);
+    pool.job = NULL;
+    while(__atomic_load_n(&job.done, __ATOMIC_ACQUIRE) < count || job.refs)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+
+    pthread_mutex_unlock(&pool.busy);
+    return;
+
+ serial:
+    for(idx = 0; idx < count; idx++)
+        fn(arg, idx);
+}
+
+void tiny_utf_parallel_shutdown(void)
+{
+    int i;
+
+    /* waits out a running job */
+    pthread_mutex_lock(&pool.busy);
+    pthread_mutex_lock(&pool.lock);
+    pool.quit = 1;
+    pthread_cond_broadcast(&pool.cond);
+    pthread_mutex_unlock(&pool.lock);
+
+    for(i = 0; i < pool.workers; i++)
+        pthread_join(pool.tids[i], NULL);
+    free(pool.tids);
+    pool.tids = NULL;
+    pool.workers = 0;
+    pool.started = 0;
+    pool.quit = 0;
+    pthread_mutex_unlock(&pool.busy);
+}
+#else
+static void pool_run(void (*fn)(void *, int), void *arg, int count)
+{
+    int idx;
+
+    for(idx = 0; idx < count; idx++)
+        fn(arg, idx);
+}
+
+void tiny_utf_parallel_shutdown(void)
+{
+}
+#endif
+
+/* smallest chunk worth shipping to another core */
+#define PARALLEL_CHUNK_MIN  (256 * 1024)
+#define PARALLEL_CHUNK_MAX  64
+
+struct parallel_chunk {
+    const unsigned char *in;
+    size_t in_sz;
+    unsigned char *out;
+    size_t out_sz;
+    int err;
+};
+
+struct parallel_conv {
+    const utf_coding *from, *to;
+    struct parallel_chunk chunk[PARALLEL_CHUNK_MAX];
+};
+
+/* move @off forward to a code point boundary of @coding */
+static size_t utf_boundary(int coding, const unsigned char *p, size_t off, size_t len)
+{
+    unsigned int u;
+
+    if(coding == UTF_CODING_UTF8)  {
+        /* never start a chunk at a 10XXXXXX continuation byte */
+        while(off < len && (p[off] & 0xC0) == 0x80)
+            off++;
+        return off;
+    }
+    if(__utf_sbcs(coding))
+        return off;
+
+    off &= ~(size_t)1;
+    if(off + 2 <= len)  {
+        u = (coding == UTF_CODING_UTF16BE) ? (p[off] << 8 | p[off + 1])
+            : (p[off] | p[off + 1] << 8);
+        /* never split a surrogate pair */
+        if(u >= 0xDC00 && u <= 0xDFFF)
+            off += 2;
+    }
+    return off < len ? off : len;
+}
+
+/*
+ * UTF8 bytes at or above 0x80, 0xC0, 0xE0 and 0xF0 into @ge, from
+ * which continuation and lead bytes of each length follow
+ */
+static void __utf8_ge(const unsigned char *p, size_t n, size_t ge[4])
+{
+    int k;
+
+#ifdef __SSE2__
+    while(n >= 16) {
+        __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0, v;
+
+        /* biased by 0x80, so signed compares order the bytes unsigned */
+        for(k = 0; k < 255 && n >= 16; k++, p += 16, n -= 16)  {
+            v = _mm_xor_si128(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8(-0x80));
+            s0 = _mm_sub_epi8(s0, _mm_cmpgt_epi8(v, _mm_set1_epi8(-1)));
+            s1 = _mm_sub_epi8(s1, _mm_cmpgt_epi8(v, _mm_set1_epi8(0x3F)));
+            s2 = _mm_sub_epi8(s2, _mm_cmpgt_epi8(v, _mm_set1_epi8(0x5F)));
+            s3 = _mm_sub_epi8(s3, _mm_cmpgt_epi8(v, _mm_set1_epi8(0x6F)));
+        }
+        s0 = _mm_sad_epu8(s0, _mm_setzero_si128());
+        s1 = _mm_sad_epu8(s1, _mm_setzero_si128());
+        s2 = _mm_sad_epu8(s2, _mm_setzero_si128());
+        s3 = _mm_sad_epu8(s3, _mm_setzero_si128());
+        ge[0] += _mm_cvtsi128_si32(s0) + _mm_extract_epi16(s0, 4);
+        ge[1] += _mm_cvtsi128_si32(s1) + _mm_extract_epi16(s1, 4);
+        ge[2] += _mm_cvtsi128_si32(s2) + _mm_extract_epi16(s2, 4);
+        ge[3] += _mm_cvtsi128_si32(s3) + _mm_extract_epi16(s3, 4);
+    }
+#endif
+    for(; n > 0; n--, p++)  {
+        ge[0] += *p >= 0x80;
+        ge[1] += *p >= 0xC0;
+        ge[2] += *p >= 0xE0;
+        ge[3] += *p >= 0xF0;
+    }
+}
+
+/* UTF16 units at or above 0x80, 0x800, 0xD800, 0xDC00 and 0xE000 into @ge */
+static void __utf16_ge(int be, const unsigned char *p, size_t n, size_t ge[5])
+{
+    unsigned int u;
+    int k;
+
+#ifdef __SSE2__
+    while(n >= 8) {
+        __m128i s[5], v, bias = _mm_set1_epi16(-0x8000);
+        int j;
+
+        for(j = 0; j < 5; j++)
+            s[j] = _mm_setzero_si128();
+        /* 16 bit lanes, no more than 0x7FFF before folding */
+        for(k = 0; k < 0x7FFF && n >= 8; k++, p += 16, n -= 8)  {
+            v = _mm_loadu_si128((const __m128i *)p);
+            if(be)
+                v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            v = _mm_xor_si128(v, bias);
+            s[0] = _mm_sub_epi16(s[0], _mm_cmpgt_epi16(v, _mm_set1_epi16(0x007F - 0x8000)));
+            s[1] = _mm_sub_epi16(s[1], _mm_cmpgt_epi16(v, _mm_set1_epi16(0x07FF - 0x8000)));
+            s[2] = _mm_sub_epi16(s[2], _mm_cmpgt_epi16(v, _mm_set1_epi16(0xD7FF - 0x8000)));
+            s[3] = _mm_sub_epi16(s[3], _mm_cmpgt_epi16(v, _mm_set1_epi16(0xDBFF - 0x8000)));
+            s[4] = _mm_sub_epi16(s[4], _mm_cmpgt_epi16(v, _mm_set1_epi16(0xDFFF - 0x8000)));
+        }
+        for(j = 0; j < 5; j++)  {
+            v = _mm_madd_epi16(s[j], _mm_set1_epi16(1));
+            v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+            v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+            ge[j] += (unsigned int)_mm_cvtsi128_si32(v);
+        }
+    }
+#endif
+    for(; n > 0; n--, p += 2)  {
+        u = be ? (p[0] << 8 | p[1]) : (p[0] | p[1] << 8);
+        ge[0] += u >= 0x80;
+        ge[1] += u >= 0x800;
+        ge[2] += u >= 0xD800;
+        ge[3] += u >= 0xDC00;
+        ge[4] += u >= 0xE000;
+    }
+}
+
+/*
+ * code points of @len bytes of @coding by UTF8 length, @n[0] for one
+ * byte up to @n[3] for four, counted from lead bytes or UTF16 units
+ * without decoding. exact for valid input only.
+ */
+static void utf_classify(int coding, const unsigned char *p, size_t len, size_t n[4])
+{
+    size_t ge[5] = {0, 0, 0, 0, 0}, i;
+    unsigned int cp;
+
+    if(coding == UTF_CODING_UTF8)  {
+        __utf8_ge(p, len, ge);
+        n[0] = len - ge[0];
+        n[1] = ge[1] - ge[2];
+        n[2] = ge[2] - ge[3];
+        n[3] = ge[3];
+    }else if(__utf_sbcs(coding))  {
+        n[0] = n[1] = n[2] = n[3] = 0;
+        for(i = 0; i < len; i++)  {
+            cp = __sbcs_to_cp(coding, p[i]);
+            n[(cp >= 0x80) + (cp >= 0x800)]++;
+        }
+    }else  {
+        /* a high surrogate stands for the pair, the low one for nothing */
+        __utf16_ge(coding == UTF_CODING_UTF16BE, p, len / 2, ge);
+        n[0] = len / 2 - ge[0];
+        n[1] = ge[0] - ge[1];
+        n[2] = ge[1] - ge[2] + ge[4];
+        n[3] = ge[2] - ge[3];
+    }
+}
+
+/* output size of a chunk, by classifying its code points */
+static void __parallel_measure(void *arg, int idx)
+{
+    struct parallel_conv *pc = (struct parallel_conv *)arg;
+    struct parallel_chunk *c = &pc->chunk[idx];
+    size_t n[4];
+
+    utf_classify(pc->from->coding, c->in, c->in_sz, n);
+    if(pc->to->coding == UTF_CODING_UTF8)
+        c->out_sz = n[0] + n[1] * 2 + n[2] * 3 + n[3] * 4;
+    else if(__utf_sbcs(pc->to->coding))
+        c->out_sz = n[0] + n[1] + n[2] + n[3];
+    else
+        c->out_sz = (n[0] + n[1] + n[2]) * 2 + n[3] * 4;
+}
+
+static void __parallel_convert(void *arg, int idx)
+{
+    struct parallel_conv *pc = (struct parallel_conv *)arg;
+    struct parallel_chunk *c = &pc->chunk[idx];
+    void *in = (void *)c->in, *out = c->out;
+    size_t in_sz = c->in_sz, out_sz = c->out_sz;
+
+    c->err = utf_do_convert(pc->from, &in, &in_sz, pc->to, &out, &out_sz, 0, 0, NULL);
+    /* sized for valid input, anything else leaves a gap or overruns */
+    if(c->err == UTF_ERR_OK && (in_sz || out_sz))
+        c->err = UTF_ERR_SIZE;
+}
+
+/*
+ * same contract as tiny_utf_convert(), input is split at code point
+ * boundaries into chunks converted across the worker pool: a first
+ * pass sizes every chunk from its lead bytes or UTF16 units, a prefix
+ * sum places them in @out, a second pass converts in place. bad or
+ * truncated input, or too small an output, falls back to a serial
+ * conversion so partial results stay identical to tiny_utf_convert(),
+ * @out past them may be clobbered.
+ * @threads: max chunks in flight, 0 for every online cpu
+ */
+int tiny_utf_convert_parallel(int from, void **in, size_t *in_sz,
+                              int to, void **out, size_t *out_sz, int threads)
+{
+    struct parallel_conv *pc;
+    const unsigned char *p;
+    size_t len, off, end, total;
+    int i, n;
+
+    if(! in || ! *in || ! in_sz || ! out || ! *out || ! out_sz)
+        return UTF_ERR_BAD_ARG;
+
+    if(threads <= 0)
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads > PARALLEL_CHUNK_MAX)
+        threads = PARALLEL_CHUNK_MAX;
+
+    len = *in_sz;
+    n = len / PARALLEL_CHUNK_MIN;
+    if(n > threads)
+        n = threads;
+
+    if(n < 2 || ! (pc = (struct parallel_conv *)malloc(sizeof(*pc))))
+        return tiny_utf_convert(from, in, in_sz, to, out, out_sz);
+
+    if(! (pc->from = utf_coding_get(from, NULL)) || ! (pc->to = utf_coding_get(to, NULL)))  {
+        free(pc);
+        return UTF_ERR_NO_SUPPORT;
+    }
+
+    p = (const unsigned char *)*in;
+    for(i = 0, off = 0; i < n; i++, off = end)  {
+        end = (i == n - 1) ? len : utf_boundary(from, p, len / n * (i + 1), len);
+        pc->chunk[i].in = p + off;
+        pc->chunk[i].in_sz = end - off;
+    }
+
+    pool_run(__parallel_measure, pc, n);
+
+    for(i = 0, total = 0; i < n; i++)  {
+        pc->chunk[i].out = (unsigned char *)*out + total;
+        total += pc->chunk[i].out_sz;
+    }
+
+    if(total > *out_sz)  {
+        free(pc);
+        return tiny_utf_convert(from, in, in_sz, to, out, out_sz);
+    }
+
+    pool_run(__parallel_convert, pc, n);
+    for(i = 0; i < n && ! pc->chunk[i].err; i++)
+        ;
+    free(pc);
+    if(i < n)
+        return tiny_utf_convert(from, in, in_sz, to, out, out_sz);
+
+    *in = (char *)*in + len;
+    *in_sz = 0;
+    *out = (char *)*out + total;
+    *out_sz -= total;
+    return UTF_ERR_OK;
+}
+
+char *tiny_utf_to_utf8(const char *text, int len, int coding)
+{
+    const char *inbuf;
+    char *outbuf, *str;
+    size_t in, sz, out, res;
+    STAT_BEGIN(t);
+
+    if(len < 0)
+        in = strlen(text);
+    else
+        in = (size_t)len;
+    sz = out = len = in;
+
+    str = (char *)malloc(sz + 1);
+    if(! str)
+        return NULL;
+
+    for(inbuf = text, outbuf = str;;)  {
+        res = tiny_utf_convert(coding, (void **)&inbuf, &in,
+                               UTF_CODING_UTF8, (void **)&outbuf, &out);
+        if(res == UTF_ERR_SIZE)  {
+            STAT_REGROW(TINY_STAT_UTF_TO_UTF8);
+            out += len;
+            sz += len;
+            str = (char *)realloc(str, sz + 1);
+            if(! str)  {
+                printf("OOM converting encoding!\n");
+                break;
+            }
+            outbuf = str + sz - out;
+            continue;
+        }
+        break;
+    }
+
+    str[sz - out] = '\0';
+    STAT_END(TINY_STAT_UTF_TO_UTF8, t, len, sz - out);
+    return str;
+}
+
+/*
+ * tiny_utf_to_utf8() of at most @max_chars code points or @max_bytes
+ * bytes, negative for no limit, stops at bad input as well. *@next
+ * gets the byte offset of @text to resume from.
+ */
+char *tiny_utf_to_utf8_range(const char *text, int len, int coding,
+                             int max_chars, int max_bytes, int *next)
+{
+    const utf_coding *from = utf_coding_get(coding, NULL);
+    unsigned int cp;
+    void *inbuf, *outbuf;
+    char *str, u[4];
+    size_t in, sz, l;
+    int chars = 0;
+    STAT_BEGIN(t);
+
+    if(len < 0)
+        in = strlen(text);
+    else
+        in = (size_t)len;
+    if(! from)
+        in = 0;
+
+    /* 3 bytes of UTF-8 take 2 bytes of UTF16, 1 byte of CP1252 */
+    sz = (from && __utf_sbcs(from->coding)) ? in * 3 : in + in / 2;
+    if(max_chars >= 0 && (size_t)max_chars * 4 < sz)
+        sz = (size_t)max_chars * 4;
+    if(max_bytes >= 0 && (size_t)max_bytes < sz)
+        sz = max_bytes;
+
+    str = (char *)malloc(sz + 1);
+    if(! str)  {
+        printf("OOM allocating str:%zu!\n", sz + 1);
+        return NULL;
+    }
+
+    for(inbuf = (void *)text, l = 0; in > 0 && chars != max_chars; chars++)  {
+        void *_in = inbuf;
+        size_t _in_sz = in, usz = sizeof(u);
+
+        outbuf = u;
+        if(from->decode(&inbuf, &in, &cp) || utf_encode_8(&outbuf, &usz, cp))
+            break;
+        if(l + sizeof(u) - usz > sz)  {
+            inbuf = _in;
+            in = _in_sz;
+            break;
+        }
+        memcpy(str + l, u, sizeof(u) - usz);
+        l += sizeof(u) - usz;
+    }
+
+    str[l] = '\0';
+    if(next)
+        *next = (const char *)inbuf - text;
+    STAT_END(TINY_STAT_UTF_TO_UTF8, t, (const char *)inbuf - text, l);
+    return str;
+}
+
+char *tiny_decode_ucs16be(const unsigned char *txt, int len)
+{
+    const unsigned short *ucs16 = (const unsigned short *)txt;
+    char *str;
+    STAT_BEGIN(t);
+
+    /* skipping ending 0xFFFF */
+    for(len /= 2; len >= 1 && ucs16[len - 1] == 0xFFFF; len--);
+    if(! len)
+        return strdup("");
+    str = tiny_utf_to_utf8((const char *)ucs16, len * 2, UTF_CODING_UTF16BE);
+    STAT_END(TINY_STAT_UCS16BE, t, len * 2, str ? strlen(str) : 0);
+    return str;
+}
+
+
+char *tiny_decode_unicode(const unsigned char *pdu, int len, int bitoffset)
+{
+    unsigned short *ucs16, *p;
+    unsigned int i, j, c, charoffset, shift;
+    char *txt = NULL;
+    STAT_BEGIN(t);
+
+    if(len <= 0)
+        return strdup("");
+    p = ucs16 = (unsigned short *)malloc(len * sizeof(unsigned short));
+    if(p)  {
+        for(i = 0, j = len, charoffset = bitoffset / 8, shift = bitoffset % 8;
+            j;
+            j--, charoffset += 2)  {
+
+            c = (pdu[charoffset] & ((1 << (8 - shift)) - 1));
+            c = ((c << 8) | pdu[charoffset + 1]);
+            if(shift > 0)
+                c = ((c << shift) | (pdu[charoffset + 2] >> (8 - shift)));
+
+            p[i++] = c;
+        }
+        txt = tiny_utf_to_utf8((const char *)ucs16, len * 2, UTF_CODING_UTF16);
+        free(ucs16);
+    }
+    STAT_END(TINY_STAT_UNICODE, t, len * 2, txt ? strlen(txt) : 0);
+    return txt;
+}
+
+
+/* load 8 bytes as a big endian word, safe for unaligned @p */
+static inline uint64_t __load_be64(const unsigned char *p)
+{
+    return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+        ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+        ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+        ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+/*
+ * replace bytes of @v (all < 0x80) not in printable ascii range
+ * [0x20, 0x7E] with space, 8 at a time without branching.
+ */
+static inline uint64_t __asc7bit_printable(uint64_t v)
+{
+    uint64_t ok, mask;
+
+    ok = ((v + 0x60 * __SWAR_ONES) & ~(v + __SWAR_ONES)) & __SWAR_HIGH;
+    mask = (ok >> 7) * 0xFF;
+    return (v & mask) | (0x20 * __SWAR_ONES & ~mask);
+}
+
+/* @str holds at least @septets + 1 bytes */
+static void __asc7bit_decode(const unsigned char *pdu, int septets, int bitoffset, char *str)
+{
+    unsigned int i, k, c, charoffset, shift, total;
+    uint64_t w, v;
+
+    /* octets covered by the septets, never read beyond */
+    total = (bitoffset + septets * 7 + 7) / 8;
+
+    /*
+     * 8 septets live in 56 bits, unpack them out of a single 64 bit
+     * big endian window, which also absorbs any sub-octet bitoffset.
+     */
+    for(i = 0; septets >= 8 && bitoffset / 8 + 8 <= total;
+        i += 8, septets -= 8, bitoffset += 56)  {
+        w = __load_be64(pdu + bitoffset / 8) << (bitoffset % 8);
+        for(v = 0, k = 0; k < 8; k++)
+            v |= ((w >> (57 - 7 * k)) & 0x7F) << (8 * k);
+        v = __asc7bit_printable(v);
+        for(k = 0; k < 8; k++)
+            str[i + k] = (char)(v >> (8 * k));
+    }
+
+    for(charoffset = bitoffset / 8, shift = bitoffset % 8;
+        septets;
+        septets--, bitoffset += 7, charoffset = bitoffset / 8, shift = bitoffset % 8)  {
+
+        if(shift > 1)  {
+            c = (pdu[charoffset] & ((1 << (8 - shift)) - 1));
+            c = ((c << (shift - 1)) | (pdu[charoffset + 1] >> (9 - shift)));
+        }else  {
+            c = ((pdu[charoffset] >> (1 - shift)) & 0x7F);
+        }
+
+        str[i++] = (char)__asc7bit_printable(c);
+    }
+
+    str[i] = '\0';
+}
+
+int tiny_decode_asc7bit_packed_r(const unsigned char *pdu, int septets, int bitoffset,
+                                 char *buf, size_t size)
+{
+    if(! pdu || ! buf || septets < 0 || size < (size_t)septets + 1)
+        return -1;
+
+    __asc7bit_decode(pdu, septets, bitoffset, buf);
+    return septets;
+}
+
+char *tiny_decode_asc7bit_packed(const unsigned char *pdu, int septets, int bitoffset)
+{
+    char *str;
+    STAT_BEGIN(t);
+
+    str = (char *)malloc(septets + 1);
+    if(! str)  {
+        printf("OOM allocating str:%d!\n", septets + 1);
+        return NULL;
+    }
+
+    __asc7bit_decode(pdu, septets, bitoffset, str);
+    STAT_END(TINY_STAT_ASC7BIT_PACKED, t, (bitoffset + septets * 7 + 7) / 8, septets);
+    return str;    
+}
+
+
+char *tiny_decode_asc7bit_unpacked(const unsigned char *pdu, int septets, int bitoffset)
+{
+    unsigned char *buf, *p;
+    unsigned int i, v, charoffset = bitoffset / 8, shift = bitoffset % 8;
+    STAT_BEGIN(t);
+
+    buf = (unsigned char *)malloc(septets + 1);
+    if(buf)  {
+        if(! shift)  {
+            memcpy(buf, pdu + charoffset, septets);
+        }else  {
+            for(i = 0, p = buf; i < septets; i++, charoffset++)  {
+                v = pdu[charoffset] & ((1 << (8 - shift)) - 1);
+                v = ((v << shift) | ((pdu[charoffset + 1] >> (8 - shift)) & ((1 << shift) - 1)));
+                *p++ = v;
+            }
+        }
+        buf[septets] = '\0';
+    }
+    STAT_END(TINY_STAT_ASC7BIT_UNPACKED, t, septets, septets);
+    return buf;
+}
+
+/* extract @len octets starting at arbitrary @bitoffset of @pdu */
+static void __bit_copy(unsigned char *dst, const unsigned char *pdu, int bitoffset, int len)
+{
+    unsigned int i, charoffset = bitoffset / 8, shift = bitoffset % 8;
+
+    if(! shift)  {
+        memcpy(dst, pdu + charoffset, len);
+        return;
+    }
+
+    for(i = 0; i < len; i++, charoffset++)
+        dst[i] = (pdu[charoffset] << shift) | (pdu[charoffset + 1] >> (8 - shift));
+}
+
+static const char __hex_lower[] = "0123456789abcdef";
+
+static inline char *__fmt_u8(char *p, unsigned int v)
+{
+    if(v >= 100)  {
+        *p++ = '0' + v / 100;
+        v %= 100;
+        *p++ = '0' + v / 10;
+    } else if(v >= 10)  {
+        *p++ = '0' + v / 10;
+    }
+    *p++ = '0' + v % 10;
+    return p;
+}
+
+static inline char *__fmt_ipv4(char *p, const unsigned char *a)
+{
+    p = __fmt_u8(p, a[0]);
+    *p++ = '.';
+    p = __fmt_u8(p, a[1]);
+    *p++ = '.';
+    p = __fmt_u8(p, a[2]);
+    *p++ = '.';
+    return __fmt_u8(p, a[3]);
+}
+
+/* hex without leading zeros */
+static inline char *__fmt_x16(char *p, unsigned int v)
+{
+    int s;
+
+    for(s = 12; s > 0 && ! (v >> s); s -= 4)
+        ;
+    for(; s >= 0; s -= 4)
+        *p++ = __hex_lower[(v >> s) & 0x0F];
+    return p;
+}
+
+/* RFC 5952 canonical text form */
+static char *__fmt_ipv6(char *p, const unsigned char *a)
+{
+    unsigned int g[8];
+    int i, cur = -1, curlen = 0, best = -1, bestlen = 1;
+
+    for(i = 0; i < 8; i++)  {
+        g[i] = (a[i * 2] << 8) | a[i * 2 + 1];
+        if(g[i])  {
+            cur = -1;
+            continue;
+        }
+        if(cur < 0)  {
+            cur = i;
+            curlen = 0;
+        }
+        if(++curlen > bestlen)  {
+            best = cur;
+            bestlen = curlen;
+        }
+    }
+
+    for(i = 0; i < 8; i++)  {
+        if(i == best)  {
+            *p++ = ':';
+            if(i + bestlen == 8)
+                *p++ = ':';
+            i += bestlen - 1;
+            continue;
+        }
+        if(i)
+            *p++ = ':';
+        /* IPv4 mapped address */
+        if(i == 6 && best == 0 && (bestlen == 6 || (bestlen == 5 && g[5] == 0xFFFF)))
+            return __fmt_ipv4(p, a + 12);
+        p = __fmt_x16(p, g[i]);
+    }
+    return p;
+}
+
+/*
+ * @alen: TINY_IPV4_ADDR_LEN or TINY_IPV6_ADDR_LEN
+ * @buf: text form output, at least TINY_INET6_ADDRSTRLEN for IPv6
+ * @bin: optional, receives the address in network order
+ * returns text length, or -1 on error
+ */
+int tiny_decode_ip_addr_r(const unsigned char *pdu, int bitoffset, int alen,
+                          char *buf, size_t size, unsigned char *bin)
+{
+    unsigned char addr[TINY_IPV6_ADDR_LEN];
+    char tmp[TINY_INET6_ADDRSTRLEN], *e;
+    STAT_BEGIN(t);
+
+    if(! pdu || ! buf || bitoffset < 0 ||
+       (alen != TINY_IPV4_ADDR_LEN && alen != TINY_IPV6_ADDR_LEN))
+        return -1;
+
+    __bit_copy(addr, pdu, bitoffset, alen);
+    if(bin)
+        memcpy(bin, addr, alen);
+
+    if(alen == TINY_IPV4_ADDR_LEN)
+        e = __fmt_ipv4(tmp, addr);
+    else
+        e = __fmt_ipv6(tmp, addr);
+
+    if(e - tmp >= size)
+        return -1;
+
+    memcpy(buf, tmp, e - tmp);
+    buf[e - tmp] = '\0';
+    STAT_END(TINY_STAT_IP_ADDR, t, alen, e - tmp);
+    return e - tmp;
+}
+
+char *tiny_decode_ip_addr(const unsigned char *pdu, int bitoffset)
+{
+    char buf[TINY_INET_ADDRSTRLEN];
+
+    if(tiny_decode_ip_addr_r(pdu, bitoffset, TINY_IPV4_ADDR_LEN, buf, sizeof(buf), NULL) < 0)
+        return NULL;
+    return strdup(buf);
+}
+
+static void __shift_table_get(struct language_shift_table *transtbl,
+                              int single_shift, int locking_shift)
+{
+    *transtbl = language_shift_table[LANG_SHIFT_GSM7BIT];
+
+    if(single_shift > 0 && single_shift < ARRAYSIZE(language_shift_table) &&
+       language_shift_table[single_shift].single) {
+        transtbl->single = language_shift_table[single_shift].single;
+    }
+
+    if(locking_shift > 0 && locking_shift < ARRAYSIZE(language_shift_table) &&
+       language_shift_table[locking_shift].locking) {
+        transtbl->locking = language_shift_table[locking_shift].locking;
+    }
+}
+
+/* a septet never takes more than 3 bytes of UTF-8 */
+#define GSM_UTF8_MAX    3
+
+/* stores 4 bytes, @out needs one spare byte past the last septet */
+static inline char *__gsm_put(char *out, int c, int esc, const struct language_shift_table *transtbl)
+{
+    const struct gsm_char *g = esc ? &transtbl->single[c] : &transtbl->locking[c];
+
+    memcpy(out, g, sizeof(*g));
+    return out + (g->len & 3);
+}
+
+/*
+ * core of the GSM 7 bit decoders, @str holds at least
+ * GSM_UTF8_MAX * @septets + 1 bytes, returns bytes written.
+ */
+static int __gsm7bit_decode(const unsigned char *pdu, int septets, int padingbits,
+                            const struct language_shift_table *transtbl, char *str)
+{
+    int esc = 0, c, bitoffset, charoffset, shift;
+    char *p = str;
+
+    for(bitoffset = padingbits, charoffset = 0, shift = padingbits;
+        septets > 0;
+        septets--, bitoffset += 7, charoffset = bitoffset / 8, shift = bitoffset % 8)  {
+
+        c = ((pdu[charoffset] >> shift) & 0x7F);
+        if(shift > 1)
+            c |= ((pdu[charoffset + 1] << (8 - shift)) & 0x7F);
+
+        if(c == 0x1B && ! esc)  {
+            esc = 1;
+            continue;
+        }
+
+        p = __gsm_put(p, c, esc, transtbl);
+        esc = 0;
+    }
+
+    *p = '\0';
+    return p - str;
+}
+
+static int __gsm8bit_decode(const unsigned char *pdu, int len,
+                            const struct language_shift_table *transtbl, char *str)
+{
+    int esc, c, j;
+    char *p = str;
+
+    for(esc = 0, j = 0; j < len; j++)  {
+        c = pdu[j] & 0x7F;
+        if(c == 0x1B && ! esc)  {
+            esc = 1;
+            continue;
+        }
+
+        p = __gsm_put(p, c, esc, transtbl);
+        esc = 0;
+    }
+
+    *p = '\0';
+    return p - str;
+}
+
+/*
+ * decode into caller buffer, @size at least GSM_UTF8_MAX * @septets + 1
+ * returns bytes written, or -1 if @size is too small.
+ */
+int tiny_decode_gsm7bit_packed_r(const unsigned char *pdu, int septets, int padingbits,
+                                 int single_shift, int locking_shift, char *buf, size_t size)
+{
+    struct language_shift_table transtbl;
+
+    if(! pdu || ! buf || septets < 0 || size < (size_t)septets * GSM_UTF8_MAX + 1)
+        return -1;
+
+    __shift_table_get(&transtbl, single_shift, locking_shift);
+    return __gsm7bit_decode(pdu, septets, padingbits, &transtbl, buf);
+}
+
+int tiny_decode_gsm8bit_unpacked_r(const unsigned char *pdu, int len,
+                                   int single_shift, int locking_shift, char *buf, size_t size)
+{
+    struct language_shift_table transtbl;
+
+    if(! pdu || ! buf || len < 0 || size < (size_t)len * GSM_UTF8_MAX + 1)
+        return -1;
+
+    __shift_table_get(&transtbl, single_shift, locking_shift);
+    return __gsm8bit_decode(pdu, len, &transtbl, buf);
+}
+
+char *tiny_decode_gsm7bit_packed_ex(const unsigned char *pdu, int septets, int padingbits,
+                                    int single_shift, int locking_shift)
+{
+    struct language_shift_table transtbl;
+    char *str;
+    int i;
+    STAT_BEGIN(t);
+
+    if(septets < 0)
+        septets = 0;
+
+    __shift_table_get(&transtbl, single_shift, locking_shift);
+
+    /* sized for the worst case up front, never regrown */
+    str = (char *)malloc(septets * GSM_UTF8_MAX + 1);
+    if(! str)  {
+        printf("OOM allocating str:%d!\n", septets * GSM_UTF8_MAX + 1);
+        return NULL;
+    }
+
+    i = __gsm7bit_decode(pdu, septets, padingbits, &transtbl, str);
+    STAT_END(TINY_STAT_GSM7BIT, t, (padingbits + septets * 7 + 7) / 8, i);
+    return str;
+}
+
+char *tiny_decode_gsm8bit_unpacked_ex(const unsigned char *pdu, int len,
+                                      int single_shift, int locking_shift)
+{
+    struct language_shift_table transtbl;
+    char *str;
+    int i;
+    STAT_BEGIN(t);
+
+    if(len < 0)
+        len = 0;
+
+    __shift_table_get(&transtbl, single_shift, locking_shift);
+
+    str = (char *)malloc(len * GSM_UTF8_MAX + 1);
+    if(! str)  {
+        printf("OOM allocating str:%d!\n", len * GSM_UTF8_MAX + 1);
+        return NULL;
+    }
+
+    i = __gsm8bit_decode(pdu, len, &transtbl, str);
+    STAT_END(TINY_STAT_GSM8BIT, t, len, i);
+    return str;
+}
+
+static inline int __gsm_septet(const unsigned char *pdu, int packed, int padingbits, int i)
+{
+    int bitoffset, c;
+
+    if(! packed)
+        return pdu[i] & 0x7F;
+
+    bitoffset = padingbits + i * 7;
+    c = pdu[bitoffset / 8] >> (bitoffset % 8);
+    if(bitoffset % 8 > 1)
+        c |= pdu[bitoffset / 8 + 1] << (8 - bitoffset % 8);
+    return c & 0x7F;
+}
+
+/*
+ * core of the range decoders, septets [@start, @n) of packed or
+ * unpacked @pdu. @str holds __gsm_range_size() bytes, returns bytes
+ * written.
+ */
+static int __gsm_decode_range(const unsigned char *pdu, int n, int packed, int padingbits,
+                              int start, int max_chars, int max_bytes,
+                              const struct language_shift_table *transtbl, char *str, int *next)
+{
+    const struct gsm_char *g;
+    int i, j, c, esc, chars = 0;
+    char *p = str;
+
+    if(start > n)
+        start = n;
+
+    /* odd run of escapes before @start, it is escaped */
+    for(i = start; i > 0 && i < n && __gsm_septet(pdu, packed, padingbits, i - 1) == 0x1B; i--)
+        ;
+    if((start - i) & 1)
+        start--;
+
+    for(i = start; i < n && chars != max_chars; i = j)  {
+        c = __gsm_septet(pdu, packed, padingbits, i);
+        j = i + 1;
+        esc = 0;
+        if(c == 0x1B)  {
+            /* a trailing escape emits nothing */
+            if(j == n)  {
+                i = n;
+                break;
+            }
+            c = __gsm_septet(pdu, packed, padingbits, j++);
+            esc = 1;
+        }
+
+        g = esc ? &transtbl->single[c] : &transtbl->locking[c];
+        if(max_bytes >= 0 && p - str + (g->len & 3) > max_bytes)
+            break;
+        p = __gsm_put(p, c, esc, transtbl);
+        chars++;
+    }
+
+    *p = '\0';
+    *next = i;
+    return p - str;
+}
+
+/* room for what __gsm_decode_range() can emit, plus the spare byte __gsm_put() stores */
+static size_t __gsm_range_size(int n, int start, int max_chars, int max_bytes)
+{
+    size_t sz;
+
+    if(start > n)
+        start = n;
+    n -= start;
+    if(max_chars >= 0 && max_chars < n)
+        n = max_chars;
+    sz = (size_t)n * GSM_UTF8_MAX;
+    if(max_bytes >= 0 && (size_t)max_bytes < sz)
+        sz = max_bytes;
+    return sz + sizeof(struct gsm_char);
+}
+
+/*
+ * for previews and paging, a @start on the second septet of an escape
+ * pair begins at its escape. allocates no more than the limits need.
+ */
+char *tiny_decode_gsm7bit_packed_range(const unsigned char *pdu, int septets, int padingbits,
+                                       int start, int max_chars, int max_bytes,
+                                       int single_shift, int locking_shift, int *next)
+{
+    struct language_shift_table transtbl;
+    char *str;
+    size_t sz;
+    int i, end;
+    STAT_BEGIN(t);
+
+    if(septets < 0)
+        septets = 0;
+    if(start < 0)
+        start = 0;
+
+    __shift_table_get(&transtbl, single_shift, locking_shift);
+
+    sz = __gsm_range_size(septets, start, max_chars, max_bytes);
+    if(! (str = (char *)malloc(sz)))  {
+        printf("OOM allocating str:%zu!\n", sz);
+        return NULL;
+    }
+
+    i = __gsm_decode_range(pdu, septets, 1, padingbits, start, max_chars, max_bytes,
+                           &transtbl, str, &end);
+    if(next)
+        *next = end;
+    STAT_END(TINY_STAT_GSM7BIT, t, end > start ? (end - start) * 7 / 8 : 0, i);
+    return str;
+}
+
+char *tiny_decode_gsm8bit_unpacked_range(const unsigned char *pdu, int len, int start,
+                                         int max_chars, int max_bytes,
+                                         int single_shift, int locking_shift, int *next)
+{
+    struct language_shift_table transtbl;
+    char *str;
+    size_t sz;
+    int i, end;
+    STAT_BEGIN(t);
+
+    if(len < 0)
+        len = 0;
+    if(start < 0)
+        start = 0;
+
+    __shift_table_get(&transtbl, single_shift, locking_shift);
+
+    sz = __gsm_range_size(len, start, max_chars, max_bytes);
+    if(! (str = (char *)malloc(sz)))  {
+        printf("OOM allocating str:%zu!\n", sz);
+        return NULL;
+    }
+
+    i = __gsm_decode_range(pdu, len, 0, 0, start, max_chars, max_bytes, &transtbl, str, &end);
+    if(next)
+        *next = end;
+    STAT_END(TINY_STAT_GSM8BIT, t, end > start ? end - start : 0, i);
+    return str;
+}
+
+/*
+ * decode cache: a fixed number of entries split over DCACHE_SHARDS
+ * shards, each a set of DCACHE_WAYS way buckets kept in most recently
+ * used order behind its own mutex. the lock only covers the bucket
+ * walk, decoding of a miss runs unlocked. entries are refcounted, the
+ * cache holds one reference and every returned string another.
+ */
+#define DCACHE_SHARDS       16
+#define DCACHE_WAYS         4
+#define DCACHE_MIN          (DCACHE_SHARDS * DCACHE_WAYS)
+
+#define DCACHE_GSM7BIT      1
+#define DCACHE_UCS16BE      2
+
+struct dcache_node {
+    unsigned int refs;
+    unsigned int klen;
+    uint64_t hash;
+    size_t len;                 /* of str, the key follows its NUL */
+    char str[];                 /* decoded text, then the key */
+};
+
+struct dcache_shard {
+    pthread_mutex_t lock;
+    struct dcache_node **slots; /* nbuckets * DCACHE_WAYS, MRU first */
+    unsigned long long hits, misses, evictions;
+    unsigned int entries;
+} __attribute__((aligned(64)));
+
+struct tiny_decode_cache {
+    struct dcache_shard shards[DCACHE_SHARDS];
+    unsigned int mask;          /* buckets per shard - 1 */
+};
+
+/* key header followed by the payload bytes */
+struct dcache_key {
+    int kind;
+    int len;                    /* septets or octets */
+    int padingbits;
+    int single_shift;
+    int locking_shift;
+};
+
+#define __DCACHE_MUL    0x9E3779B97F4A7C15ULL
+
+static inline uint64_t __dcache_mix(uint64_t h, uint64_t w)
+{
+    h = (h ^ w) * __DCACHE_MUL;
+    return h ^ (h >> 29);
+}
+
+static uint64_t __dcache_hash(const struct dcache_key *k, const unsigned char *p, size_t len)
+{
+    uint64_t h = __dcache_mix(len, ((uint64_t)k->kind << 32) | (uint32_t)k->len);
+    uint64_t w;
+
+    h = __dcache_mix(h, ((uint64_t)k->padingbits << 32) | (uint32_t)k->single_shift);
+    h = __dcache_mix(h, (uint32_t)k->locking_shift);
+    for(; len >= 8; len -= 8, p += 8)  {
+        memcpy(&w, p, 8);
+        h = __dcache_mix(h, w);
+    }
+    for(w = 0; len; len--)
+        w = (w << 8) | *p++;
+    return __dcache_mix(h, w);
+}
+
+static inline struct dcache_node *__dcache_node(const char *str)
+{
+    return (struct dcache_node *)(str - offsetof(struct dcache_node, str));
+}
+
+static inline const unsigned char *__dcache_node_key(const struct dcache_node *n)
+{
+    return (const unsigned char *)n->str + n->len + 1;
+}
+
+static inline void __dcache_put(struct dcache_node *n)
+{
+    if(n && ! __atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL))
+        free(n);
+}
+
+tiny_decode_cache *tiny_decode_cache_new(unsigned int entries)
+{
+    tiny_decode_cache *cache;
+    unsigned int i, buckets = 1;
+
+    if(entries < DCACHE_MIN)
+        entries = DCACHE_MIN;
+    while(buckets * DCACHE_MIN < entries)
+        buckets <<= 1;
+
+    if(posix_memalign((void **)&cache, 64, sizeof(*cache)))  {
+        printf("OOM allocating decode cache!\n");
+        return NULL;
+    }
+    memset(cache, 0, sizeof(*cache));
+    cache->mask = buckets - 1;
+    for(i = 0; i < DCACHE_SHARDS; i++)  {
+        cache->shards[i].slots = (struct dcache_node **)calloc(buckets * DCACHE_WAYS,
+                                                               sizeof(struct dcache_node *));
+        if(! cache->shards[i].slots)  {
+            printf("OOM allocating decode cache slots:%u!\n", buckets * DCACHE_WAYS);
+            while(i--)  {
+                pthread_mutex_destroy(&cache->shards[i].lock);
+                free(cache->shards[i].slots);
+            }
+            free(cache);
+            return NULL;
+        }
+        pthread_mutex_init(&cache->shards[i].lock, NULL);
+    }
+    return cache;
+}
+
+/* returned strings stay valid until released */
+void tiny_decode_cache_free(tiny_decode_cache *cache)
+{
+    unsigned int i, j;
+
+    if(! cache)
+        return;
+    for(i = 0; i < DCACHE_SHARDS; i++)  {
+        for(j = 0; j < (cache->mask + 1) * DCACHE_WAYS; j++)
+            __dcache_put(cache->shards[i].slots[j]);
+        pthread_mutex_destroy(&cache->shards[i].lock);
+        free(cache->shards[i].slots);
+    }
+    free(cache);
+}
+
+void tiny_decode_cache_release(const char *str)
+{
+    if(str)
+        __dcache_put(__dcache_node(str));
+}
+
+void tiny_decode_cache_stats(tiny_decode_cache *cache, struct tiny_decode_cache_stats *st)
+{
+    struct dcache_shard *s;
+    unsigned int i;
+
+    memset(st, 0, sizeof(*st));
+    for(i = 0; i < DCACHE_SHARDS; i++)  {
+        s = &cache->shards[i];
+        pthread_mutex_lock(&s->lock);
+        st->hits += s->hits;
+        st->misses += s->misses;
+        st->evictions += s->evictions;
+        st->entries += s->entries;
+        pthread_mutex_unlock(&s->lock);
+    }
+    st->capacity = DCACHE_MIN * (cache->mask + 1);
+}
+
+/* find @key in its bucket, moving it to the front, or take a reference on @add */
+static struct dcache_node *__dcache_lookup(tiny_decode_cache *cache, uint64_t hash,
+                                           const unsigned char *key, size_t klen,
+                                           struct dcache_node *add)
+{
+    struct dcache_shard *s = &cache->shards[hash & (DCACHE_SHARDS - 1)];
+    struct dcache_node **b, *n, *old = NULL;
+    int i;
+
+    b = s->slots + ((hash >> 4) & cache->mask) * DCACHE_WAYS;
+    pthread_mutex_lock(&s->lock);
+    for(i = 0; i < DCACHE_WAYS && (n = b[i]); i++)  {
+        if(n->hash == hash && n->klen == klen && ! memcmp(__dcache_node_key(n), key, klen))
+            break;
+    }
+
+    if(i < DCACHE_WAYS && n)  {
+        /* raced with another miss on the same key, keep the first */
+        if(! add)
+            s->hits++;
+        __atomic_add_fetch(&n->refs, 1, __ATOMIC_RELAXED);
+    }else if(add)  {
+        n = add;
+        i = DCACHE_WAYS - 1;
+        if((old = b[i]))
+            s->evictions++;
+        else
+            s->entries++;
+        /* one for the cache, one for the caller */
+        add->refs = 2;
+    }else  {
+        s->misses++;
+        pthread_mutex_unlock(&s->lock);
+        return NULL;
+    }
+
+    memmove(b + 1, b, i * sizeof(*b));
+    b[0] = n;
+    pthread_mutex_unlock(&s->lock);
+
+    if(add && n != add)
+        free(add);
+    __dcache_put(old);
+    return n;
+}
+
+/* @str of @len bytes, decoded from @key, in a node of its own */
+static struct dcache_node *__dcache_node_new(uint64_t hash, const char *str, size_t len,
+                                             const unsigned char *key, size_t klen)
+{
+    struct dcache_node *n;
+
+    n = (struct dcache_node *)malloc(sizeof(*n) + len + 1 + klen);
+    if(! n)  {
+        printf("OOM allocating cache node:%zu!\n", sizeof(*n) + len + 1 + klen);
+        return NULL;
+    }
+    n->refs = 0;
+    n->klen = klen;
+    n->hash = hash;
+    n->len = len;
+    memcpy(n->str, str, len);
+    n->str[len] = '\0';
+    memcpy(n->str + len + 1, key, klen);
+    return n;
+}
+
+/* the key of a payload of @len bytes, in @buf if it fits */
+static unsigned char *__dcache_key(const struct dcache_key *k, const unsigned char *pdu,
+                                   size_t len, unsigned char *buf, size_t size)
+{
+    unsigned char *key = buf;
+
+    if(sizeof(*k) + len > size && ! (key = (unsigned char *)malloc(sizeof(*k) + len)))  {
+        printf("OOM allocating cache key:%zu!\n", sizeof(*k) + len);
+        return NULL;
+    }
+    memcpy(key, k, sizeof(*k));
+    memcpy(key + sizeof(*k), pdu, len);
+    return key;
+}
+
+static const char *__dcache_get(tiny_decode_cache *cache, const struct dcache_key *k,
+                                const unsigned char *pdu, size_t len)
+{
+    unsigned char kbuf[sizeof(*k) + 160], *key;
+    struct dcache_node *n = NULL;
+    uint64_t hash;
+    char *str;
+
+    if(! (key = __dcache_key(k, pdu, len, kbuf, sizeof(kbuf))))
+        return NULL;
+
+    hash = __dcache_hash(k, pdu, len);
+    if(! (n = __dcache_lookup(cache, hash, key, sizeof(*k) + len, NULL)))  {
+        if(k->kind == DCACHE_GSM7BIT)
+            str = tiny_decode_gsm7bit_packed_ex(pdu, k->len, k->padingbits,
+                                                k->single_shift, k->locking_shift);
+        else
+            str = tiny_decode_ucs16be(pdu, k->len);
+
+        if(str)  {
+            n = __dcache_node_new(hash, str, strlen(str), key, sizeof(*k) + len);
+            free(str);
+        }
+        if(n)
+            n = __dcache_lookup(cache, hash, key, sizeof(*k) + len, n);
+    }
+
+    if(key != kbuf)
+        free(key);
+    return n ? n->str : NULL;
+}
+
+/*
+ * as tiny_decode_gsm7bit_packed_ex(), but byte identical payloads
+ * decoded before come from @cache. release the result with
+ * tiny_decode_cache_release().
+ */
+const char *tiny_decode_cache_gsm7bit_packed(tiny_decode_cache *cache, const unsigned char *pdu,
+                                             int septets, int padingbits,
+                                             int single_shift, int locking_shift)
+{
+    struct dcache_key k;
+
+    if(septets < 0)
+        septets = 0;
+    if(padingbits < 0)
+        padingbits = 0;
+
+    memset(&k, 0, sizeof(k));
+    k.kind = DCACHE_GSM7BIT;
+    k.len = septets;
+    k.padingbits = padingbits;
+    k.single_shift = single_shift;
+    k.locking_shift = locking_shift;
+    return __dcache_get(cache, &k, pdu, ((size_t)septets * 7 + padingbits + 7) / 8);
+}
+
+/* as tiny_decode_ucs16be(), see tiny_decode_cache_gsm7bit_packed() */
+const char *tiny_decode_cache_ucs16be(tiny_decode_cache *cache, const unsigned char *txt, int len)
+{
+    struct dcache_key k;
+
+    if(len < 0)
+        len = 0;
+
+    memset(&k, 0, sizeof(k));
+    k.kind = DCACHE_UCS16BE;
+    k.len = len;
+    return __dcache_get(cache, &k, txt, len);
+}
+
+/*
+ * cell broadcast, TS 23.041 9.4.1.2: serial number, message identifier,
+ * DCS and page parameter ahead of CBS_CONTENT_SIZE content octets,
+ * unused content padded with CR.
+ */
+#define CBS_HEADER_SIZE     (CBS_PAGE_SIZE - CBS_CONTENT_SIZE)
+#define CBS_SEPTETS         (CBS_CONTENT_SIZE * 8 / 7)
+#define CBS_MAX_PAGES       15
+#define CBS_PENDING         16
+#define CBS_WAYS            4
+
+/* TS 23.038 5, DCS coding groups 0000 and 0010 */
+static const char cbs_lang_group0[16][3] = {
+    "de", "en", "it", "fr", "es", "nl", "sv", "da",
+    "pt", "fi", "no", "el", "tr", "hu", "pl", "",
+};
+
+static const char cbs_lang_group2[16][3] = {
+    "cs", "he", "ar", "ru", "is",
+};
+
+struct cbs_pending {
+    uint64_t key;               /* serial, message id and pages, 0 if unused */
+    unsigned int have;          /* bitmap of pages stored */
+    unsigned int age;
+    unsigned char pdu[CBS_MAX_PAGES][CBS_PAGE_SIZE];
+};
+
+struct tiny_cbs_assembler {
+    uint64_t *seen;             /* nbuckets * CBS_WAYS page keys, MRU first */
+    unsigned int mask;
+    unsigned int clock;
+    struct cbs_pending pending[CBS_PENDING];
+};
+
+/* first two septets of @p as the language prefix */
+static void __cbs_lang_prefix(const unsigned char *p, char *lang)
+{
+    lang[0] = p[0] & 0x7F;
+    lang[1] = ((p[0] >> 7) | (p[1] << 1)) & 0x7F;
+    lang[2] = '\0';
+    if(! isalpha((unsigned char)lang[0]) || ! isalpha((unsigned char)lang[1]))
+        lang[0] = '\0';
+}
+
+/*
+ * TS 23.038 5 CBS data coding scheme @dcs into @page coding, language,
+ * prefix and header flags, also used by USSD. -1 if compressed.
+ */
+static int __cbs_dcs(unsigned int dcs, const unsigned char *content, struct tiny_cbs_page *page)
+{
+    page->dcs = dcs;
+    page->coding = CBS_CODING_GSM7;
+    switch(dcs >> 4)  {
+    case 0x0:
+        memcpy(page->lang, cbs_lang_group0[dcs & 0x0F], 3);
+        break;
+    case 0x1:
+        if(dcs == 0x10 || dcs == 0x11)  {
+            page->lang_prefix = 1;
+            if(content)
+                __cbs_lang_prefix(content, page->lang);
+            if(dcs == 0x11)
+                page->coding = CBS_CODING_UCS2;
+        }
+        break;
+    case 0x2:
+        memcpy(page->lang, cbs_lang_group2[dcs & 0x0F], 3);
+        break;
+    case 0x4: case 0x5: case 0x6: case 0x7:
+        /* compressed */
+        if(dcs & 0x20)
+            return -1;
+        /* fall through */
+    case 0x9:
+        if(((dcs >> 2) & 0x03) == 1)
+            page->coding = CBS_CODING_8BIT;
+        else if(((dcs >> 2) & 0x03) == 2)
+            page->coding = CBS_CODING_UCS2;
+        page->udh = (dcs >> 4) == 0x9;
+        break;
+    case 0xF:
+        if(dcs & 0x04)
+            page->coding = CBS_CODING_8BIT;
+        break;
+    }
+    return 0;
+}
+
+int tiny_cbs_page_parse(const unsigned char *pdu, int len, struct tiny_cbs_page *page)
+{
+    if(! pdu || ! page || len < CBS_PAGE_SIZE)
+        return -1;
+
+    memset(page, 0, sizeof(*page));
+    page->serial = (pdu[0] << 8) | pdu[1];
+    page->msg_id = (pdu[2] << 8) | pdu[3];
+    page->page = pdu[5] >> 4;
+    page->pages = pdu[5] & 0x0F;
+    page->content = pdu + CBS_HEADER_SIZE;
+
+    /* 0000 in either nibble means a single page */
+    if(! page->page || ! page->pages)
+        page->page = page->pages = 1;
+    if(page->page > page->pages)
+        return -1;
+
+    return __cbs_dcs(pdu[4], page->content, page);
+}
+
+/* decode @n content blocks in page order into one contiguous message */
+static struct tiny_cbs_message *__cbs_decode(const struct tiny_cbs_page *pages, int n)
+{
+    struct language_shift_table transtbl;
+    struct tiny_cbs_message *msg, *m;
+    unsigned char ucs2[CBS_MAX_PAGES * CBS_CONTENT_SIZE];
+    const unsigned char *c;
+    size_t ulen = 0, osz, skip, l;
+    void *i, *o;
+    char *p;
+    int k, s;
+
+    msg = (struct tiny_cbs_message *)malloc(sizeof(*msg) + n * CBS_SEPTETS * GSM_UTF8_MAX + 1);
+    if(! msg)  {
+        printf("OOM allocating cbs message:%d!\n", n);
+        return NULL;
+    }
+    msg->text = (char *)(msg + 1);
+    msg->serial = pages[0].serial;
+    msg->msg_id = pages[0].msg_id;
+    msg->dcs = pages[0].dcs;
+    msg->coding = pages[0].coding;
+    msg->pages = n;
+    memcpy(msg->lang, pages[0].lang, sizeof(msg->lang));
+
+    __shift_table_get(&transtbl, LANG_SHIFT_GSM7BIT, LANG_SHIFT_GSM7BIT);
+    for(p = msg->text, k = 0; k < n; k++)  {
+        c = pages[k].content;
+        skip = pages[k].udh ? c[0] + 1 : 0;
+        if(skip > CBS_CONTENT_SIZE)
+            skip = CBS_CONTENT_SIZE;
+
+        if(msg->coding == CBS_CODING_GSM7)  {
+            /* header padded to a septet boundary, language as "xx\r" */
+            s = pages[k].lang_prefix ? 3 : (skip * 8 + 6) / 7;
+            l = __gsm7bit_decode(c + s * 7 / 8, CBS_SEPTETS - s, s * 7 % 8, &transtbl, p);
+            while(l && p[l - 1] == '\r')
+                l--;
+            p += l;
+        }else  {
+            if(pages[k].lang_prefix)
+                skip = 2;
+            if(msg->coding == CBS_CODING_UCS2)  {
+                memcpy(ucs2 + ulen, c + skip, CBS_CONTENT_SIZE - skip);
+                ulen += CBS_CONTENT_SIZE - skip;
+            }else  {
+                memcpy(p, c + skip, CBS_CONTENT_SIZE - skip);
+                p += CBS_CONTENT_SIZE - skip;
+            }
+        }
+    }
+
+    if(msg->coding == CBS_CODING_UCS2)  {
+        ulen &= ~(size_t)1;
+        while(ulen >= 2 && ucs2[ulen - 2] == 0x00 && ucs2[ulen - 1] == '\r')
+            ulen -= 2;
+        i = ucs2;
+        o = p;
+        osz = n * CBS_SEPTETS * GSM_UTF8_MAX;
+        tiny_utf_convert_ex(UTF_CODING_UTF16BE, &i, &ulen, UTF_CODING_UTF8, &o, &osz,
+                            UTF_CONV_REPLACE, 0, NULL);
+        p = (char *)o;
+    }
+
+    *p = '\0';
+    msg->len = p - msg->text;
+    if((m = (struct tiny_cbs_message *)realloc(msg, sizeof(*msg) + msg->len + 1)))
+        msg = m;
+    msg->text = (char *)(msg + 1);
+    return msg;
 }
 
-int tiny_utf_convert_name(const char *from, void **in, size_t *in_sz,
-                          const char *to, void **out, size_t *out_sz)
+struct tiny_cbs_message *tiny_decode_cbs_page(const unsigned char *pdu, int len)
 {
-    const utf_coding *fcoding = utf_coding_get(UTF_CODING_INVALID, from);
-    const utf_coding *tcoding = utf_coding_get(UTF_CODING_INVALID, to);
+    struct tiny_cbs_page page;
 
-    if(! fcoding || ! tcoding)
-        return UTF_ERR_NO_SUPPORT;
-
-    return utf_do_convert(fcoding, in, in_sz, tcoding, out, out_sz);
+    if(tiny_cbs_page_parse(pdu, len, &page))
+        return NULL;
+    return __cbs_decode(&page, 1);
 }
 
-char *tiny_utf_to_utf8(const char *text, int len, int coding)
+tiny_cbs_assembler *tiny_cbs_assembler_new(unsigned int seen)
 {
-    const char *inbuf;
-    char *outbuf, *str;
-    size_t in, sz, out, res;
+    tiny_cbs_assembler *cbs;
+    unsigned int buckets = 1;
 
-    if(len < 0)
-        in = strlen(text);
-    else
-        in = (size_t)len;
-    sz = out = len = in;
+    while(buckets * CBS_WAYS < seen)
+        buckets <<= 1;
 
-    str = (char *)malloc(sz + 1);
-    if(! str)
+    if(! (cbs = (tiny_cbs_assembler *)calloc(1, sizeof(*cbs))))  {
+        printf("OOM allocating cbs assembler!\n");
+        return NULL;
+    }
+    if(! (cbs->seen = (uint64_t *)calloc(buckets * CBS_WAYS, sizeof(uint64_t))))  {
+        printf("OOM allocating cbs seen set:%u!\n", buckets * CBS_WAYS);
+        free(cbs);
         return NULL;
+    }
+    cbs->mask = buckets - 1;
+    return cbs;
+}
 
-    for(inbuf = text, outbuf = str;;)  {
-        res = tiny_utf_convert(coding, (void **)&inbuf, &in,
-                               UTF_CODING_UTF8, (void **)&outbuf, &out);
-        if(res == UTF_ERR_SIZE)  {
-            out += len;
-            sz += len;
-            str = (char *)realloc(str, sz + 1);
-            if(! str)  {
-                printf("OOM converting encoding!\n");
-                break;
-            }
-            outbuf = str + sz - out;
-            continue;
-        }
-        break;
+void tiny_cbs_assembler_free(tiny_cbs_assembler *cbs)
+{
+    if(cbs)  {
+        free(cbs->seen);
+        free(cbs);
     }
+}
 
-    str[sz - out] = '\0';
-    return str;
+static inline uint64_t __cbs_key(const struct tiny_cbs_page *page, int n)
+{
+    return (1ULL << 63) | ((uint64_t)page->serial << 32) | ((uint64_t)page->msg_id << 16) |
+        (n << 4) | page->pages;
 }
 
-char *tiny_decode_ucs16be(const unsigned char *txt, int len)
+/* bucket of page key @key */
+static inline uint64_t *__cbs_bucket(const tiny_cbs_assembler *cbs, uint64_t key)
 {
-    const unsigned short *ucs16 = (const unsigned short *)txt;
+    return cbs->seen + (((key * __DCACHE_MUL) >> 40) & cbs->mask) * CBS_WAYS;
+}
 
-    /* skipping ending 0xFFFF */
-    for(len /= 2; len >= 1 && ucs16[len - 1] == 0xFFFF; len--);
-    if(! len)
-        return strdup("");
-    return tiny_utf_to_utf8((const char *)ucs16, len * 2, UTF_CODING_UTF16BE);
+static int __cbs_seen(const tiny_cbs_assembler *cbs, uint64_t key)
+{
+    const uint64_t *b = __cbs_bucket(cbs, key);
+
+    return b[0] == key || b[1] == key || b[2] == key || b[3] == key;
 }
 
+static void __cbs_mark_seen(tiny_cbs_assembler *cbs, uint64_t key)
+{
+    uint64_t *b = __cbs_bucket(cbs, key);
 
-char *tiny_decode_unicode(const unsigned char *pdu, int len, int bitoffset)
+    memmove(b + 1, b, (CBS_WAYS - 1) * sizeof(*b));
+    b[0] = key;
+}
+
+/*
+ * feed one page, returns 1 with a newly completed message in @msg, 0 if
+ * the page was a repeat or the message still misses pages, -1 if the
+ * page is malformed. pages already seen are dropped after a probe of
+ * the seen set, without decoding anything.
+ */
+int tiny_cbs_assembler_feed(tiny_cbs_assembler *cbs, const unsigned char *pdu, int len,
+                            struct tiny_cbs_message **msg)
 {
-    unsigned short *ucs16, *p;
-    unsigned int i, j, c, charoffset, shift;
-    char *txt = NULL;
+    struct tiny_cbs_page pages[CBS_MAX_PAGES];
+    struct cbs_pending *pend = NULL, *old;
+    uint64_t key, mkey;
+    int i;
 
-    p = ucs16 = (unsigned short *)malloc(len * sizeof(unsigned short));
-    if(p)  {
-        for(i = 0, j = len, charoffset = bitoffset / 8, shift = bitoffset % 8;
-            j;
-            j--, charoffset += 2)  {
+    *msg = NULL;
+    if(tiny_cbs_page_parse(pdu, len, &pages[0]))
+        return -1;
 
-            c = (pdu[charoffset] & ((1 << (8 - shift)) - 1));
-            c = ((c << 8) | pdu[charoffset + 1]);
-            if(shift > 0)
-                c = ((c << shift) | (pdu[charoffset + 2] >> (8 - shift)));
+    key = __cbs_key(&pages[0], pages[0].page);
+    if(__cbs_seen(cbs, key))
+        return 0;
 
-            p[i++] = c;
+    if(pages[0].pages == 1)  {
+        if(! (*msg = __cbs_decode(&pages[0], 1)))
+            return -1;
+        __cbs_mark_seen(cbs, key);
+        return 1;
+    }
+
+    /* page 0 never occurs in a key, so it names the whole message */
+    mkey = __cbs_key(&pages[0], 0);
+    for(old = &cbs->pending[0], i = 0; i < CBS_PENDING; i++)  {
+        if(cbs->pending[i].key == mkey)  {
+            pend = &cbs->pending[i];
+            break;
         }
-        txt = tiny_utf_to_utf8((const char *)ucs16, len * 2, UTF_CODING_UTF16);
-        free(ucs16);
+        if(cbs->pending[i].age < old->age)
+            old = &cbs->pending[i];
     }
-    return txt;
+
+    if(! pend)  {
+        pend = old;
+        pend->key = mkey;
+        pend->have = 0;
+    }
+    pend->age = ++cbs->clock;
+    if(pend->have & (1 << pages[0].page))
+        return 0;
+
+    memcpy(pend->pdu[pages[0].page - 1], pdu, CBS_PAGE_SIZE);
+    pend->have |= 1 << pages[0].page;
+    if(pend->have != ((2U << pages[0].pages) - 2))
+        return 0;
+
+    for(i = 0; i < pages[0].pages; i++)
+        tiny_cbs_page_parse(pend->pdu[i], CBS_PAGE_SIZE, &pages[i]);
+    if(! (*msg = __cbs_decode(pages, pages[0].pages)))
+        return -1;
+
+    for(i = 0; i < pages[0].pages; i++)
+        __cbs_mark_seen(cbs, __cbs_key(&pages[i], pages[i].page));
+    pend->key = 0;
+    pend->age = 0;
+    return 1;
 }
 
+/*
+ * reverse of a shift table, code point to septet. built once for every
+ * row of gsm_tables, languages sharing a row share its reverse too.
+ */
+#define GSM_REV_NONE    0xFF
+
+struct gsm_rev_entry {
+    unsigned int cp;
+    unsigned int code;
+};
 
-char *tiny_decode_asc7bit_packed(const unsigned char *pdu, int septets, int bitoffset)
+struct gsm_rev_table {
+    unsigned char low[256];
+    unsigned int nr;
+    struct gsm_rev_entry high[128];     /* sorted by code point */
+};
+
+static struct gsm_rev_table *gsm_rev[GSM_TBL_MAX];
+static struct gsm_rev_table *gsm_rev_locking[ARRAYSIZE(language_shift_table)];
+static struct gsm_rev_table *gsm_rev_single[ARRAYSIZE(language_shift_table)];
+static pthread_once_t gsm_rev_once = PTHREAD_ONCE_INIT;
+
+/*
+ * transliteration of common characters missing from every table into
+ * default alphabet text, sorted by code point, empty ones dropped.
+ */
+struct gsm_translit {
+    unsigned short cp;
+    char rep[4];
+};
+
+static const struct gsm_translit gsm_translit[] = {
+    {0x0009, " "}, {0x0060, "'"}, {0x00A0, " "}, {0x00A6, "|"}, {0x00A8, "\""}, {0x00A9, "(c)"},
+    {0x00AA, "a"}, {0x00AB, "\""}, {0x00AD, "-"}, {0x00AE, "(R)"}, {0x00B2, "2"}, {0x00B3, "3"},
+    {0x00B4, "'"}, {0x00B7, "."}, {0x00B9, "1"}, {0x00BA, "o"}, {0x00BB, "\""}, {0x00BC, "1/4"},
+    {0x00BD, "1/2"}, {0x00BE, "3/4"}, {0x00C0, "A"}, {0x00C1, "A"}, {0x00C2, "A"},
+    {0x00C3, "A"}, {0x00C8, "E"}, {0x00CA, "E"}, {0x00CB, "E"}, {0x00CC, "I"}, {0x00CD, "I"},
+    {0x00CE, "I"}, {0x00CF, "I"}, {0x00D0, "D"}, {0x00D2, "O"}, {0x00D3, "O"}, {0x00D4, "O"},
+    {0x00D5, "O"}, {0x00D7, "x"}, {0x00D9, "U"}, {0x00DA, "U"}, {0x00DB, "U"}, {0x00DD, "Y"},
+    {0x00DE, "Th"}, {0x00E1, "a"}, {0x00E2, "a"}, {0x00E3, "a"}, {0x00E7, "Ç"}, {0x00EA, "e"},
+    {0x00EB, "e"}, {0x00ED, "i"}, {0x00EE, "i"}, {0x00EF, "i"}, {0x00F0, "d"}, {0x00F3, "o"},
+    {0x00F4, "o"}, {0x00F5, "o"}, {0x00F7, "/"}, {0x00FA, "u"}, {0x00FB, "u"}, {0x00FD, "y"},
+    {0x00FE, "th"}, {0x00FF, "y"}, {0x0100, "A"}, {0x0101, "a"}, {0x0102, "A"}, {0x0103, "a"},
+    {0x0104, "A"}, {0x0105, "a"}, {0x0106, "C"}, {0x0107, "c"}, {0x0108, "C"}, {0x0109, "c"},
+    {0x010A, "C"}, {0x010B, "c"}, {0x010C, "C"}, {0x010D, "c"}, {0x010E, "D"}, {0x010F, "d"},
+    {0x0110, "D"}, {0x0111, "d"}, {0x0112, "E"}, {0x0113, "e"}, {0x0114, "E"}, {0x0115, "e"},
+    {0x0116, "E"}, {0x0117, "e"}, {0x0118, "E"}, {0x0119, "e"}, {0x011A, "E"}, {0x011B, "e"},
+    {0x011C, "G"}, {0x011D, "g"}, {0x011E, "G"}, {0x011F, "g"}, {0x0120, "G"}, {0x0121, "g"},
+    {0x0122, "G"}, {0x0123, "g"}, {0x0124, "H"}, {0x0125, "h"}, {0x0126, "H"}, {0x0127, "h"},
+    {0x0128, "I"}, {0x0129, "i"}, {0x012A, "I"}, {0x012B, "i"}, {0x012C, "I"}, {0x012D, "i"},
+    {0x012E, "I"}, {0x012F, "i"}, {0x0130, "I"}, {0x0131, "i"}, {0x0132, "IJ"}, {0x0133, "ij"},
+    {0x0134, "J"}, {0x0135, "j"}, {0x0136, "K"}, {0x0137, "k"}, {0x0138, "k"}, {0x0139, "L"},
+    {0x013A, "l"}, {0x013B, "L"}, {0x013C, "l"}, {0x013D, "L"}, {0x013E, "l"}, {0x013F, "L"},
+    {0x0140, "l"}, {0x0141, "L"}, {0x0142, "l"}, {0x0143, "N"}, {0x0144, "n"}, {0x0145, "N"},
+    {0x0146, "n"}, {0x0147, "N"}, {0x0148, "n"}, {0x0149, "'n"}, {0x014A, "N"}, {0x014B, "n"},
+    {0x014C, "O"}, {0x014D, "o"}, {0x014E, "O"}, {0x014F, "o"}, {0x0150, "Ö"}, {0x0151, "ö"},
+    {0x0152, "OE"}, {0x0153, "oe"}, {0x0154, "R"}, {0x0155, "r"}, {0x0156, "R"}, {0x0157, "r"},
+    {0x0158, "R"}, {0x0159, "r"}, {0x015A, "S"}, {0x015B, "s"}, {0x015C, "S"}, {0x015D, "s"},
+    {0x015E, "S"}, {0x015F, "s"}, {0x0160, "S"}, {0x0161, "s"}, {0x0162, "T"}, {0x0163, "t"},
+    {0x0164, "T"}, {0x0165, "t"}, {0x0166, "T"}, {0x0167, "t"}, {0x0168, "U"}, {0x0169, "u"},
+    {0x016A, "U"}, {0x016B, "u"}, {0x016C, "U"}, {0x016D, "u"}, {0x016E, "U"}, {0x016F, "u"},
+    {0x0170, "Ü"}, {0x0171, "ü"}, {0x0172, "U"}, {0x0173, "u"}, {0x0174, "W"}, {0x0175, "w"},
+    {0x0176, "Y"}, {0x0177, "y"}, {0x0178, "Y"}, {0x0179, "Z"}, {0x017A, "z"}, {0x017B, "Z"},
+    {0x017C, "z"}, {0x017D, "Z"}, {0x017E, "z"}, {0x017F, "s"}, {0x0218, "S"}, {0x0219, "s"},
+    {0x021A, "T"}, {0x021B, "t"}, {0x0386, "A"}, {0x0388, "E"}, {0x0389, "H"}, {0x038A, "I"},
+    {0x038C, "O"}, {0x038E, "Y"}, {0x038F, "Ω"}, {0x0390, "I"}, {0x0391, "A"}, {0x0392, "B"},
+    {0x0395, "E"}, {0x0396, "Z"}, {0x0397, "H"}, {0x0399, "I"}, {0x039A, "K"}, {0x039C, "M"},
+    {0x039D, "N"}, {0x039F, "O"}, {0x03A1, "P"}, {0x03A4, "T"}, {0x03A5, "Y"}, {0x03A7, "X"},
+    {0x03AA, "I"}, {0x03AB, "Y"}, {0x03AC, "A"}, {0x03AD, "E"}, {0x03AE, "H"}, {0x03AF, "I"},
+    {0x03B0, "Y"}, {0x03B1, "A"}, {0x03B2, "B"}, {0x03B3, "Γ"}, {0x03B4, "Δ"}, {0x03B5, "E"},
+    {0x03B6, "Z"}, {0x03B7, "H"}, {0x03B8, "Θ"}, {0x03B9, "I"}, {0x03BA, "K"}, {0x03BB, "Λ"},
+    {0x03BC, "M"}, {0x03BD, "N"}, {0x03BE, "Ξ"}, {0x03BF, "O"}, {0x03C0, "Π"}, {0x03C1, "P"},
+    {0x03C2, "Σ"}, {0x03C3, "Σ"}, {0x03C4, "T"}, {0x03C5, "Y"}, {0x03C6, "Φ"}, {0x03C7, "X"},
+    {0x03C8, "Ψ"}, {0x03C9, "Ω"}, {0x03CA, "I"}, {0x03CB, "Y"}, {0x03CC, "O"}, {0x03CD, "Y"},
+    {0x03CE, "Ω"}, {0x2002, " "}, {0x2003, " "}, {0x2004, " "}, {0x2005, " "}, {0x2006, " "},
+    {0x2007, " "}, {0x2008, " "}, {0x2009, " "}, {0x200A, " "}, {0x200B, ""}, {0x200C, ""},
+    {0x200D, ""}, {0x2010, "-"}, {0x2011, "-"}, {0x2012, "-"}, {0x2013, "-"}, {0x2014, "-"},
+    {0x2015, "-"}, {0x2018, "'"}, {0x2019, "'"}, {0x201A, "'"}, {0x201B, "'"}, {0x201C, "\""},
+    {0x201D, "\""}, {0x201E, "\""}, {0x201F, "\""}, {0x2020, "+"}, {0x2022, "*"}, {0x2024, "."},
+    {0x2026, "..."}, {0x202F, " "}, {0x2032, "'"}, {0x2033, "\""}, {0x2039, "<"}, {0x203A, ">"},
+    {0x2044, "/"}, {0x2122, "TM"}, {0x2212, "-"}, {0x2215, "/"}, {0x3000, " "}, {0xFEFF, ""},
+};
+
+static inline unsigned int __gsm_rev(const struct gsm_rev_table *rev, unsigned int cp)
 {
-    char *str;
-    unsigned int i, c, charoffset, shift;
+    unsigned int lo = 0, hi = rev->nr, mid;
+
+    if(cp < 256)
+        return rev->low[cp];
+    while(lo < hi)  {
+        mid = (lo + hi) / 2;
+        if(rev->high[mid].cp == cp)
+            return rev->high[mid].code;
+        if(rev->high[mid].cp < cp)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return GSM_REV_NONE;
+}
 
-    str = (char *)malloc(septets + 1);
-    if(! str)  {
-        printf("OOM allocating str:%d!\n", septets + 1);
-        return NULL;
+static const char *__gsm_translit(unsigned int cp)
+{
+    unsigned int lo = 0, hi = ARRAYSIZE(gsm_translit), mid;
+
+    while(lo < hi)  {
+        mid = (lo + hi) / 2;
+        if(gsm_translit[mid].cp == cp)
+            return gsm_translit[mid].rep;
+        if(gsm_translit[mid].cp < cp)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
+    return NULL;
+}
 
-    for(i = 0, charoffset = bitoffset / 8, shift = bitoffset % 8;
-        septets;
-        septets--, bitoffset += 7, charoffset = bitoffset / 8, shift = bitoffset % 8)  {
+static int __gsm_rev_cmp(const void *a, const void *b)
+{
+    const struct gsm_rev_entry *x = a, *y = b;
 
-        if(shift > 1)  {
-            c = (pdu[charoffset] & ((1 << (8 - shift)) - 1));
-            c = ((c << (shift - 1)) | (pdu[charoffset + 1] >> (9 - shift)));
+    if(x->cp != y->cp)
+        return x->cp < y->cp ? -1 : 1;
+    return x->code < y->code ? -1 : x->code > y->code;
+}
+
+static struct gsm_rev_table *__gsm_rev_build(const struct gsm_char *tbl)
+{
+    unsigned int row = (tbl - gsm_tables[0]) / 128;
+    struct gsm_rev_table *rev;
+    unsigned int i, c, cp;
+    size_t sz;
+    void *p;
+
+    if(gsm_rev[row])
+        return gsm_rev[row];
+
+    if(! (rev = (struct gsm_rev_table *)calloc(1, sizeof(*rev))))  {
+        printf("OOM allocating gsm reverse table!\n");
+        return NULL;
+    }
+    memset(rev->low, GSM_REV_NONE, sizeof(rev->low));
+    for(c = 0; c < 128; c++)  {
+        if((tbl[c].len & GSM_CHAR_UNDEF) || c == 0x1B)
+            continue;
+        p = (void *)tbl[c].utf8;
+        sz = tbl[c].len;
+        if(utf_decode_8(&p, &sz, &cp))
+            continue;
+        if(cp < 256)  {
+            if(rev->low[cp] == GSM_REV_NONE)
+                rev->low[cp] = c;
         }else  {
-            c = ((pdu[charoffset] >> (1 - shift)) & 0x7F);
+            rev->high[rev->nr].cp = cp;
+            rev->high[rev->nr++].code = c;
         }
+    }
+    /* duplicates ordered by septet, the lower one wins */
+    qsort(rev->high, rev->nr, sizeof(rev->high[0]), __gsm_rev_cmp);
+    for(i = c = 0; i < rev->nr; i++)  {
+        if(! c || rev->high[c - 1].cp != rev->high[i].cp)
+            rev->high[c++] = rev->high[i];
+    }
+    rev->nr = c;
+    gsm_rev[row] = rev;
+    return rev;
+}
 
-        if(! isprint(c))
-            c = ' ';
+static void __gsm_rev_init(void)
+{
+    unsigned int i;
 
-        str[i++] = c;
+    for(i = 0; i < ARRAYSIZE(language_shift_table); i++)  {
+        if(language_shift_table[i].locking)
+            gsm_rev_locking[i] = __gsm_rev_build(language_shift_table[i].locking);
+        if(language_shift_table[i].single)
+            gsm_rev_single[i] = __gsm_rev_build(language_shift_table[i].single);
     }
+}
 
-    str[i] = '\0';
-    return str;    
+/* reverse tables of a shift table pair, as picked by __shift_table_get() */
+static int __gsm_rev_get(int single_shift, int locking_shift,
+                         const struct gsm_rev_table **single, const struct gsm_rev_table **locking)
+{
+    pthread_once(&gsm_rev_once, __gsm_rev_init);
+
+    *single = gsm_rev_single[LANG_SHIFT_GSM7BIT];
+    *locking = gsm_rev_locking[LANG_SHIFT_GSM7BIT];
+    if(single_shift > 0 && single_shift < ARRAYSIZE(language_shift_table) &&
+       gsm_rev_single[single_shift])
+        *single = gsm_rev_single[single_shift];
+    if(locking_shift > 0 && locking_shift < ARRAYSIZE(language_shift_table) &&
+       gsm_rev_locking[locking_shift])
+        *locking = gsm_rev_locking[locking_shift];
+    return *single && *locking ? 0 : -1;
 }
 
+/* septets packed 8 to 7 octets, LSB first, after @bits fill bits */
+struct septet_packer {
+    unsigned char *p;
+    uint64_t acc;
+    int bits;
+    int n, max;
+};
 
-char *tiny_decode_asc7bit_unpacked(const unsigned char *pdu, int septets, int bitoffset)
+static inline int __pack7(struct septet_packer *pk, unsigned int c)
 {
-    unsigned char *buf, *p;
-    unsigned int i, v, charoffset = bitoffset / 8, shift = bitoffset % 8;
+    int i;
 
-    buf = (unsigned char *)malloc(septets + 1);
-    if(buf)  {
-        if(! shift)  {
-            memcpy(buf, pdu + charoffset, septets);
+    if(pk->n >= pk->max)
+        return -1;
+    pk->acc |= (uint64_t)c << pk->bits;
+    pk->n++;
+    if((pk->bits += 7) >= 56)  {
+        for(i = 0; i < 7; i++)
+            pk->p[i] = pk->acc >> (i * 8);
+        pk->p += 7;
+        pk->acc >>= 56;
+        pk->bits -= 56;
+    }
+    return 0;
+}
+
+static inline void __pack7_flush(struct septet_packer *pk)
+{
+    int i;
+
+    for(i = 0; i < pk->bits; i += 8)
+        *pk->p++ = pk->acc >> i;
+}
+
+/* @cp from the locking or else the single shift table, -2 if in neither */
+static inline int __gsm_put7(struct septet_packer *pk, unsigned int cp,
+                             const struct gsm_rev_table *single, const struct gsm_rev_table *locking)
+{
+    unsigned int code;
+
+    if((code = __gsm_rev(locking, cp)) != GSM_REV_NONE)
+        return __pack7(pk, code);
+    if((code = __gsm_rev(single, cp)) != GSM_REV_NONE)
+        return __pack7(pk, 0x1B) || __pack7(pk, code) ? -1 : 0;
+    return -2;
+}
+
+/*
+ * UTF-8 @text as septets of the @single/@locking tables, characters in
+ * neither transliterated if @flags has GSM_ENC_TRANSLIT. 0 on success,
+ * -1 if out of room, -2 on unmappable or invalid text.
+ */
+static int __gsm7bit_encode(struct septet_packer *pk, const char *text, size_t len,
+                            const struct gsm_rev_table *single, const struct gsm_rev_table *locking,
+                            int flags)
+{
+    const char *rep;
+    unsigned int cp;
+    size_t sz;
+    void *p;
+    int res;
+
+    while(len)  {
+        if((unsigned char)*text < 0x80)  {
+            cp = (unsigned char)*text++;
+            len--;
         }else  {
-            for(i = 0, p = buf; i < septets; i++, charoffset++)  {
-                v = pdu[charoffset] & ((1 << (8 - shift)) - 1);
-                v = ((v << shift) | ((pdu[charoffset + 1] >> (8 - shift)) & ((1 << shift) - 1)));
-                *p++ = v;
-            }
+            p = (void *)text;
+            if(utf_decode_8(&p, &len, &cp))
+                return -2;
+            text = (const char *)p;
+        }
+
+        if((res = __gsm_put7(pk, cp, single, locking)) != -2)  {
+            if(res)
+                return res;
+            continue;
+        }
+
+        if(! (flags & GSM_ENC_TRANSLIT) || ! (rep = __gsm_translit(cp)))
+            return -2;
+        for(p = (void *)rep, sz = strlen(rep); sz; )  {
+            utf_decode_8(&p, &sz, &cp);
+            if((res = __gsm_put7(pk, cp, single, locking)))
+                return res;
         }
-        buf[septets] = '\0';
     }
-    return buf;
+    return 0;
 }
 
-char *tiny_decode_ip_addr(const unsigned char *pdu, int bitoffset)
+/*
+ * encode UTF-8 @text as GSM 7 bit septets packed from bit @padingbits
+ * of @pdu, fill bits zeroed. returns septets written, -1 on bad
+ * arguments or a too small @pdu, -2 if a character maps to neither
+ * shift table and has no transliteration or GSM_ENC_TRANSLIT is unset.
+ */
+int tiny_encode_gsm7bit_packed_r(const char *text, int len, int padingbits,
+                                 int single_shift, int locking_shift, int flags,
+                                 unsigned char *pdu, size_t size)
 {
-    unsigned int v, charoffset = bitoffset / 8, shift = bitoffset % 8;
-    unsigned char *buf = NULL, *p = (unsigned char *)&v;
+    const struct gsm_rev_table *single, *locking;
+    struct septet_packer pk;
+    int res;
 
-    if(! shift)
-        v = pdu[charoffset++];
-    else
-        v = pdu[charoffset++] & ((1 << (8 - shift)) - 1);
-    v = (v << 8) | pdu[charoffset++];
-    v = (v << 8) | pdu[charoffset++];
-    if(! shift)
-        v = (v << 8) | pdu[charoffset++];
-    else
-        v = (v << shift) | ((pdu[charoffset] >> (8 - shift)) & ((1 << shift) - 1));
+    if(! text || ! pdu || len < 0 || padingbits < 0)
+        return -1;
+    /* septets are counted in an int, room past that is never used */
+    if(size > INT_MAX / 8)
+        size = INT_MAX / 8;
+    if(size * 8 < (size_t)padingbits)
+        return -1;
+    if(__gsm_rev_get(single_shift, locking_shift, &single, &locking))
+        return -1;
 
-    if(__big_endian())
-        asprintf((char **)&buf, "%d.%d.%d.%d", p[0], p[1], p[2], p[3]);
-    else
-        asprintf((char **)&buf, "%d.%d.%d.%d", p[3], p[2], p[1], p[0]);
+    memset(&pk, 0, sizeof(pk));
+    pk.p = pdu + padingbits / 8;
+    pk.bits = padingbits % 8;
+    pk.max = (size * 8 - padingbits) / 7;
+    if((res = __gsm7bit_encode(&pk, text, len, single, locking, flags)))
+        return res;
+    __pack7_flush(&pk);
+    return pk.n;
+}
 
-    return buf;
+/*
+ * USSD string, TS 23.038 5 and 6.1.2.3.1, into @buf of at least
+ * GSM_UTF8_MAX * @len * 8 / 7 + 1 bytes. the CR filling 7 spare bits
+ * of the last octet is dropped. @lang, if given, gets the language of
+ * @dcs or its prefix. returns bytes written, -1 on bad arguments.
+ */
+int tiny_decode_ussd_r(const unsigned char *pdu, int len, int dcs, char *buf, size_t size,
+                       char *lang)
+{
+    struct language_shift_table transtbl;
+    struct tiny_cbs_page info;
+    int septets, s, n;
+    size_t isz, osz;
+    void *i, *o;
+
+    if(! pdu || ! buf || len < 0 || size < (size_t)len * 8 / 7 * GSM_UTF8_MAX + 1)
+        return -1;
+
+    memset(&info, 0, sizeof(info));
+    if(__cbs_dcs(dcs, len >= 2 ? pdu : NULL, &info))
+        return -1;
+    if(lang)
+        memcpy(lang, info.lang, sizeof(info.lang));
+
+    s = info.udh && len ? pdu[0] + 1 : 0;
+    if(s > len)
+        s = len;
+
+    if(info.coding == CBS_CODING_GSM7)  {
+        septets = len * 8 / 7;
+        if(len && len % 7 == 0 && pdu[len - 1] >> 1 == '\r')
+            septets--;
+        /* header padded to a septet boundary, language as "xx\r" */
+        s = info.lang_prefix ? 3 : (s * 8 + 6) / 7;
+        if(s > septets)
+            s = septets;
+        __shift_table_get(&transtbl, LANG_SHIFT_GSM7BIT, LANG_SHIFT_GSM7BIT);
+        return __gsm7bit_decode(pdu + s * 7 / 8, septets - s, s * 7 % 8, &transtbl, buf);
+    }
+
+    if(info.lang_prefix)
+        s = len < 2 ? len : 2;
+    if(info.coding == CBS_CODING_8BIT)  {
+        memcpy(buf, pdu + s, len - s);
+        buf[len - s] = '\0';
+        return len - s;
+    }
+
+    i = (void *)(pdu + s);
+    isz = (len - s) & ~1;
+    o = buf;
+    osz = size - 1;
+    tiny_utf_convert_ex(UTF_CODING_UTF16BE, &i, &isz, UTF_CODING_UTF8, &o, &osz,
+                        UTF_CONV_REPLACE, 0, NULL);
+    n = (char *)o - buf;
+    buf[n] = '\0';
+    return n;
 }
 
-char *tiny_decode_gsm7bit_packed_ex(const unsigned char *pdu, int septets, int padingbits,
-                                    int single_shift, int locking_shift)
+/*
+ * encode UTF-8 @text as a USSD string of data coding scheme @dcs into
+ * @pdu, two letter @lang leads the text if @dcs calls for it. GSM 7 bit
+ * output is CR padded so 7 spare bits never read as '@', and a final CR
+ * on an octet boundary is doubled. returns octets written, -1 on bad
+ * arguments, unmappable text or a too small @pdu.
+ */
+int tiny_encode_ussd_r(const char *text, int len, int dcs, const char *lang,
+                       unsigned char *pdu, size_t size)
 {
-    char *str, *p;
-    int esc = 0, c, bitoffset, charoffset, shift;
-    int i, sz = septets;
-    struct language_shift_table transtbl = language_shift_table[LANG_SHIFT_GSM7BIT];
+    const struct gsm_rev_table *single, *locking;
+    struct tiny_cbs_page info;
+    struct septet_packer pk;
+    size_t isz, osz;
+    void *i, *o;
+
+    if(! text || ! pdu || len < 0)
+        return -1;
 
-    if(single_shift > 0 && single_shift < ARRAYSIZE(language_shift_table)) {
-        transtbl.single = language_shift_table[single_shift].single;
+    memset(&info, 0, sizeof(info));
+    if(__cbs_dcs(dcs, NULL, &info) || info.udh)
+        return -1;
+    if(info.lang_prefix && (! lang || ! isalpha((unsigned char)lang[0]) ||
+                            ! isalpha((unsigned char)lang[1])))
+        return -1;
+
+    memset(&pk, 0, sizeof(pk));
+    pk.p = pdu;
+    pk.max = size > INT_MAX / 8 ? INT_MAX / 8 : size * 8 / 7;
+
+    if(info.coding == CBS_CODING_GSM7)  {
+        if(__gsm_rev_get(LANG_SHIFT_GSM7BIT, LANG_SHIFT_GSM7BIT, &single, &locking))
+            return -1;
+        if(info.lang_prefix && (__pack7(&pk, lang[0]) || __pack7(&pk, lang[1]) ||
+                                __pack7(&pk, '\r')))
+            return -1;
+        if(__gsm7bit_encode(&pk, text, len, single, locking, 0))
+            return -1;
+        if(pk.n % 8 == 7 || (pk.n % 8 == 0 && pk.n && len && text[len - 1] == '\r'))  {
+            if(__pack7(&pk, '\r'))
+                return -1;
+        }
+        __pack7_flush(&pk);
+        return pk.p - pdu;
     }
 
-    if(locking_shift > 0 && locking_shift < ARRAYSIZE(language_shift_table)) {
-        transtbl.locking = language_shift_table[locking_shift].locking;
+    /* language as two packed septets */
+    if(info.lang_prefix)  {
+        if(size < 2)
+            return -1;
+        __pack7(&pk, lang[0]);
+        __pack7(&pk, lang[1]);
+        __pack7_flush(&pk);
     }
 
-    str = (char *)malloc(sz + 1);
-    if(! str)  {
-        printf("OOM allocating str:%d!\n", sz + 1);
-        return NULL;
+    if(info.coding == CBS_CODING_8BIT)  {
+        if(size - (pk.p - pdu) < (size_t)len)
+            return -1;
+        memcpy(pk.p, text, len);
+        return pk.p - pdu + len;
     }
 
-    for(i = 0, bitoffset = padingbits, charoffset = 0, shift = padingbits;
-        septets;
-        septets--, bitoffset += 7, charoffset = bitoffset / 8, shift = bitoffset % 8)  {
+    i = (void *)text;
+    isz = len;
+    o = pk.p;
+    osz = size - (pk.p - pdu);
+    if(tiny_utf_convert(UTF_CODING_UTF8, &i, &isz, UTF_CODING_UTF16BE, &o, &osz))
+        return -1;
+    return (unsigned char *)o - pdu;
+}
 
-        c = ((pdu[charoffset] >> shift) & 0x7F);
-        if(shift > 1)
-            c |= ((pdu[charoffset + 1] << (8 - shift)) & 0x7F);
 
-        if(c == 0x1B)  {
-            esc = 1;
-            continue;
-        }
+/*
+ * append GSM default alphabet septet @c (escaped if @esc) as UTF-8 at
+ * @out, at most 3 bytes written, returns bytes written.
+ */
+static inline int __gsm_default_to_utf8(char *out, int c, int esc)
+{
+    const struct gsm_char *g = &gsm_tables[esc ? GSM_TBL_DEFAULT_EX : GSM_TBL_DEFAULT][c];
+    int l = g->len & 3;
+
+    out[0] = g->utf8[0];
+    if(l > 1)
+        out[1] = g->utf8[1];
+    if(l > 2)
+        out[2] = g->utf8[2];
+    return l;
+}
 
-        if(i + 4 > sz)  {
-            sz += (septets / 2 ? : 4);
-            p = (char *)realloc(str, sz + 1);
-            if(! p)  {
-                printf("OOM realloc str!\n");
-                str[i] = '\0';
-                return str;
-            }
-            str = p;
-        }
+/*
+ * decode ADN style 0x81/0x82 UCS2 characters straight to UTF-8, each
+ * input octet emits at most 3 bytes, @out must be sized accordingly.
+ * decoding stops at the first 0xFF padding octet.
+ */
+static int __ucs2_to_utf8(const unsigned char *pdu, unsigned int base, int len, char *out)
+{
+    void *o = out;
+    size_t sz = (size_t)len * 3;
+    int i, esc = 0;
 
-        if(esc)  {
-            /* fake a invalid escaped char as a space */
-            if(! transtbl.single[c])
-                str[i++] = ' ';
-            else  {
-                strcpy(str + i, transtbl.single[c]);
-                i += strlen(transtbl.single[c]);
-            }
+    for(i = 0; i < len && pdu[i] != 0xFF; i++)  {
+        if(pdu[i] & 0x80)  {
             esc = 0;
+            if(utf_encode_8(&o, &sz, base + (pdu[i] & 0x7F)) != UTF_ERR_OK)
+                break;
+            continue;
+        }
+
+        if(pdu[i] == 0x1B)  {
+            esc = 1;
             continue;
         }
 
-        strcpy(str + i, transtbl.locking[c]);
-        i += strlen(transtbl.locking[c]);
+        o = (char *)o + __gsm_default_to_utf8((char *)o, pdu[i], esc);
+        sz = (size_t)len * 3 - ((char *)o - out);
+        esc = 0;
     }
 
-    str[i] = '\0';
-    return str;    
+    return (char *)o - out;
 }
 
-char *tiny_decode_gsm8bit_unpacked_ex(const unsigned char *pdu, int len,
-                                      int single_shift, int locking_shift)
+/* 0x80 coded UCS2, trailing 0xFFFF ignored, stops at bad code */
+static int __ucs16be_to_utf8(const unsigned char *pdu, int len, char *out)
 {
-    char *str, *p;
-    int esc, c, i, j, sz = len;
-    struct language_shift_table transtbl = language_shift_table[LANG_SHIFT_GSM7BIT];
+    void *in, *o = out;
+    size_t in_sz, sz = (size_t)len * 3 / 2 + 1;
 
-    if(single_shift > 0 && single_shift < ARRAYSIZE(language_shift_table)) {
-        transtbl.single = language_shift_table[single_shift].single;
-    }
+    for(len &= ~1; len >= 2 && pdu[len - 2] == 0xFF && pdu[len - 1] == 0xFF; len -= 2)
+        ;
+
+    in = (void *)pdu;
+    in_sz = len;
+    tiny_utf_convert(UTF_CODING_UTF16BE, &in, &in_sz, UTF_CODING_UTF8, &o, &sz);
+    return (char *)o - out;
+}
+
+/*
+ * single pass EF_ADN alpha identifier decoder, @out must hold at
+ * least 3 * @len bytes, returns bytes written, not NUL terminated.
+ */
+static int __adn_to_utf8(const unsigned char *pdu, int len, char *out)
+{
+    const char *o = out;
+    unsigned int base;
+    int i, l, esc;
 
-    if(locking_shift > 0 && locking_shift < ARRAYSIZE(language_shift_table)) {
-        transtbl.locking = language_shift_table[locking_shift].locking;
+    if(len >= 1 && pdu[0] == 0x80)
+        return __ucs16be_to_utf8(pdu + 1, len - 1, out);
+
+    if(len >= 3 && pdu[0] == 0x81)  {
+        l = pdu[1];
+        if(l > len - 3)
+            l = len - 3;
+        base = pdu[2] << 7;
+        return __ucs2_to_utf8(pdu + 3, base, l, out);
     }
 
-    str = (char *)malloc(sz + 1);
-    if(! str)  {
-        printf("OOM allocating str:%d!\n", sz + 1);
-        return NULL;
+    if(len >= 4 && pdu[0] == 0x82)  {
+        l = pdu[1];
+        if(l > len - 4)
+            l = len - 4;
+        base = (pdu[2] << 8) | pdu[3];
+        return __ucs2_to_utf8(pdu + 4, base, l, out);
     }
 
-    for(esc = 0, i = 0, j = 0; j < len; j++)  {
-        c = pdu[j] & 0x7F;
-        if(c == 0x1B)  {
+    for(esc = 0, i = 0; i < len && pdu[i] != 0xFF; i++)  {
+        if((pdu[i] & 0x7F) == 0x1B)  {
             esc = 1;
             continue;
         }
-
-        if(i + 4 > sz)  {
-            sz += (len / 2 ? : 4);
-            p = (char *)realloc(str, sz + 1);
-            if(! str)  {
-                printf("OOM realloc str!\n");
-                str[i] = '\0';
-                return str;
-            }
-            str = p;
-        }
-
-        if(esc)  {
-            /* fake a invalid escaped char as a space */
-            if(! transtbl.single[c])
-                str[i++] = ' ';
-            else  {
-                strcpy(str + i, transtbl.single[c]);
-                i += strlen(transtbl.single[c]);
-            }
-            esc = 0;
-            continue;
-        }
-
-        strcpy(str + i, transtbl.locking[c]);
-        i += strlen(transtbl.locking[c]);
+        out += __gsm_default_to_utf8(out, pdu[i] & 0x7F, esc);
+        esc = 0;
     }
-
-    str[i] = '\0';
-    return str;
+    return out - o;
 }
 
-
-char *tiny_decode_ucs2(const char *pdu, char base, int len)
+char *tiny_decode_ucs2(const char *pdu, unsigned int base, int len)
 {
-    char *ret, *tmp;
-    size_t sz = len;
-    int i, j, m;
+    char *ret;
+    int l;
+    STAT_BEGIN(t);
+
+    if(len < 0)
+        len = 0;
 
-    ret = (char *)malloc(sz + 1);
+    ret = (char *)malloc(len * 3 + 1);
     if(! ret)  {
         printf("OOM alloc buffer!\n");
         return NULL;
     }
 
-    for(i = 0, j = 0; i < len;)  {
-        if(j == sz)  {
-            sz += len;
-            ret = (char *)realloc(ret, sz);
-            if(! ret)  {
-                printf("OOM enlarge buffer\n");
-                break;
-            }
-        }
+    l = __ucs2_to_utf8((const unsigned char *)pdu, base, len, ret);
+    ret[l] = '\0';
+    STAT_END(TINY_STAT_UCS2, t, len, l);
+    return ret;
+}
 
-        if(pdu[i] < 0)
-            ret[j++] = (char)(base + (pdu[i++] & 0x7F));
+/* @size at least 3 * @len + 1, returns bytes written */
+int tiny_decode_adn_r(const unsigned char *pdu, int len, char *buf, size_t size)
+{
+    int l;
 
-        for(m = i; m < len && pdu[m] >= 0; m++)
-            ;
+    if(! pdu || ! buf || len < 0 || size < (size_t)len * 3 + 1)
+        return -1;
 
-        tmp = tiny_decode_gsm8bit_unpacked(pdu + i, m - i);
-        if(tmp)  {
-            int l = strlen(tmp);
+    l = __adn_to_utf8(pdu, len, buf);
+    buf[l] = '\0';
+    return l;
+}
 
-            if(l > sz - j)  {
-                sz += l;
-                ret = (char *)realloc(ret, sz);
-                if(! ret)  {
-                    printf("OOM enlarge buffer\n");
-                    break;
-                }
-            }
-            strcpy(ret + j, tmp);
-            j += l;
-            free(tmp);
-        }
-        i += m;
+char *tiny_decode_adn(const unsigned char *pdu, int len)
+{
+    char *ret;
+    int l;
+    STAT_BEGIN(t);
+
+    if(len <= 0)
+        return strdup("");
+
+    ret = (char *)malloc(len * 3 + 1);
+    if(! ret)  {
+        printf("OOM alloc buffer!\n");
+        return NULL;
     }
 
-    ret[j] = '\0';
+    l = __adn_to_utf8(pdu, len, ret);
+    ret[l] = '\0';
+    STAT_END(TINY_STAT_ADN, t, len, l);
     return ret;
 }
 
-char *tiny_decode_adn(const unsigned char *pdu, int len)
+/* EF_ADN record tail: BCD len, TON/NPI, 10 octets number, CCP, EXT */
+#define ADN_TAIL_LEN    14
+#define ADN_NUMBER_MAX  10
+
+/*
+ * @reclen: fixed EF_ADN record length, at least 14
+ * returns a single block holding @num decoded non-empty records, with
+ * a last entry of NULL alpha, release with free().
+ */
+struct tiny_adn_record *tiny_decode_adn_ef(const unsigned char *ef, int len, int reclen, int *num)
 {
-    int i = 0, l = 0, ucs2 = 0;
-    char base = '\0';
+    struct tiny_adn_record *recs, *rec;
+    const unsigned char *r, *bcd;
+    int i, cnt, alen, blen, digits;
+    char *content;
+    unsigned char v;
+    STAT_BEGIN(t);
+
+    if(! ef || reclen < ADN_TAIL_LEN || len < reclen)
+        return NULL;
 
-    if(! len)
-        return strdup("");
+    cnt = len / reclen;
+    alen = reclen - ADN_TAIL_LEN;
 
-    if(len >= 1 && pdu[i] == 0x80)
-        return tiny_decode_ucs16be(pdu + 1, len - 1);
+    /* worst case: 3 bytes per alpha octet, '+' and 2 digits per BCD octet */
+    recs = (struct tiny_adn_record *)malloc(sizeof(*recs) * (cnt + 1) +
+                                            (size_t)cnt * (alen * 3 + 1 + ADN_NUMBER_MAX * 2 + 2));
+    if(! recs)  {
+        printf("OOM alloc buffer!\n");
+        return NULL;
+    }
 
-    if(len >= 3 && pdu[i] == 0x81)  {
-        l = pdu[i + 1] & 0xff;
-        if(l > len - 3)
-            l = len - 3;
-        base = (char)((pdu[i + 2] & 0xff) << 7);
-        i += 3;
-        ucs2 = 1;
-    }else if(len >= 4 && pdu[i] == 0x82)  {
-        l = pdu[i + 1] & 0xff;
-        if(l > len - 4)
-            l = len - 4;
-        base = (char)(((pdu[i + 2] & 0xff) << 8) | (pdu[i + 3] & 0xff));
-        i += 4;
-        ucs2 = 1;
+    rec = recs;
+    content = (char *)(recs + cnt + 1);
+    for(i = 0, r = ef; i < cnt; i++, r += reclen)  {
+        bcd = r + alen;
+
+        /* unused records are filled with 0xFF */
+        if(r[0] == 0xFF && bcd[0] == 0xFF)
+            continue;
+
+        rec->index = i + 1;
+        rec->alpha = content;
+        content += __adn_to_utf8(r, alen, content);
+        *content++ = '\0';
+
+        rec->number = content;
+        blen = bcd[0];
+        if(blen != 0xFF && blen > 1)  {
+            if(blen > ADN_NUMBER_MAX + 1)
+                blen = ADN_NUMBER_MAX + 1;
+
+            /* international number */
+            if((bcd[1] & 0x70) == 0x10)
+                *content++ = '+';
+
+            for(digits = 0; digits < (blen - 1) * 2; digits++)  {
+                v = bcd[2 + digits / 2];
+                v = (digits & 1) ? (v >> 4) : (v & 0x0F);
+                if(v == 0x0F)
+                    break;
+                *content++ = bcd_tbl[v];
+            }
+        }
+        *content++ = '\0';
+        rec++;
     }
 
-    if(ucs2)
-        return tiny_decode_ucs2(pdu + i, base, len - i);
+    rec->index = 0;
+    rec->alpha = rec->number = NULL;
+    if(num)
+        *num = rec - recs;
 
-    return tiny_decode_gsm8bit_unpacked(pdu, len);
+    STAT_END(TINY_STAT_ADN_EF, t, (size_t)cnt * reclen, content - (char *)recs);
+    return recs;
 }
 
 int tiny_decode_bcd(unsigned char pdu)
@@ -1078,6 +4004,7 @@ unsigned char *tiny_decode_bcd_num(const unsigned char *pdu, int sz)
 {
     unsigned char *num = (unsigned char *)malloc(sz + 1), idx;
     int  i;
+    STAT_BEGIN(t);
 
     if(num)  {
         for(i = 0; i < sz;)  {
@@ -1095,6 +4022,7 @@ unsigned char *tiny_decode_bcd_num(const unsigned char *pdu, int sz)
             num[i++] = bcd_tbl[idx];
         }
         num[i] = '\0';
+        STAT_END(TINY_STAT_BCD_NUM, t, (sz + 1) / 2, i);
     }
 
     return num;
@@ -1106,6 +4034,7 @@ unsigned char *tiny_decode_bcd_num_cdma(const unsigned char *pdu, int sz, int bi
     const unsigned char *buf;
     unsigned char *p, *num;
     unsigned int i, v, len, charoffset = bitoffset / 8, shift = bitoffset % 8;
+    STAT_BEGIN(t);
 
     if(! shift)  {
         buf = pdu + charoffset;
@@ -1131,21 +4060,50 @@ unsigned char *tiny_decode_bcd_num_cdma(const unsigned char *pdu, int sz, int bi
             num[i++] = (v < ARRAYSIZE(cdma_bcd_tbl)) ? cdma_bcd_tbl[v] : 'x';
         }
         num[i] = '\0';
+        STAT_END(TINY_STAT_BCD_NUM, t, (sz + 1) / 2, i);
     }
 
     return num;
 }
 
+/* 256 bit membership bitmap of junk chars */
+typedef struct {
+    uint32_t bits[8];
+} junk_map;
+
+/* " \f\t\n\r\v" */
+static const junk_map junk_map_space = {
+    {0x00003E00, 0x00000001, 0, 0, 0, 0, 0, 0},
+};
+
+static const junk_map *__junk_map(junk_map *map, const char *junk)
+{
+    const unsigned char *p = (const unsigned char *)junk;
+
+    if(! junk || ! junk[0] || ! strcmp(junk, " \f\t\n\r\v"))
+        return &junk_map_space;
+
+    memset(map, 0, sizeof(*map));
+    for(; *p; p++)
+        map->bits[*p >> 5] |= 1U << (*p & 31);
+    return map;
+}
+
+static inline int __is_junk(const junk_map *map, unsigned char c)
+{
+    return (map->bits[c >> 5] >> (c & 31)) & 1;
+}
+
 char *tiny_string_trim(char *string, const char *junk, int flag)
 {
-    const char *_junk = " \f\t\n\r\v";
-    char *s = string, *p = string, *_e, *e;
+    const junk_map *map;
+    junk_map _map;
+    char *s = string, *p = string, *e;
 
     if(! string || ! string[0])
         return s;
 
-    if(! junk || ! junk[0])
-        junk = _junk;
+    map = __junk_map(&_map, junk);
 
     if(! (flag & TRIM_IN_PLACE))
         string = strdup(string);
@@ -1155,26 +4113,23 @@ char *tiny_string_trim(char *string, const char *junk, int flag)
     if(! string || ! (flag & TRIM_ALL))
         return string;
 
-    while(*p && strchr(junk, *p))
+    while(*p && __is_junk(map, *p))
         p++;
 
     if(! (flag & TRIM_FRONT)) {
         s = p;
     }
 
-    /* last non-junk char */
-    for(e = _e = p; *_e; _e++) {
-        if(! strchr(junk, *_e))
-            e = _e;
-    }
+    /* last non-junk char, scanning backward from the end */
+    for(e = p + strlen(p); e > p && __is_junk(map, *(e - 1)); e--)
+        ;
+    e = (e > p) ? e - 1 : p;
 
     if(flag & TRIM_MIDDLE) {
-        while(*p && p <= e) {
-            if(! strchr(junk, *p)) {
-                *s++ = *p++;
-                continue;
-            }
-            p++;
+        /* branch free compaction, always store, advance on non-junk */
+        for(; *p && p <= e; p++) {
+            *s = *p;
+            s += ! __is_junk(map, *p);
         }
     } else {
         while(*p && p <= e)
@@ -1190,12 +4145,81 @@ char *tiny_string_trim(char *string, const char *junk, int flag)
     return string;
 }
 
+/*
+ * trim front and end junk without copying or modifying @string,
+ * returns the start of the trimmed view with its length in @len.
+ */
+const char *tiny_string_trim_view(const char *string, const char *junk, size_t *len)
+{
+    const junk_map *map;
+    junk_map _map;
+    const char *p, *e;
+
+    if(! string)
+        return NULL;
+
+    map = __junk_map(&_map, junk);
+    for(p = string; *p && __is_junk(map, *p); p++)
+        ;
+    for(e = p + strlen(p); e > p && __is_junk(map, *(e - 1)); e--)
+        ;
+
+    if(len)
+        *len = e - p;
+    return p;
+}
+
+/*
+ * first occurrence of @delim in [@p, @end), NULL if none. memchr() is
+ * vectorized by libc, so single char delimiters are a plain SIMD scan,
+ * longer ones are anchored on their first char and verified.
+ */
+static inline const char *__delim_find(const char *p, const char *end,
+                                       const char *delim, size_t dlen)
+{
+    if(dlen == 1)
+        return (const char *)memchr(p, delim[0], end - p);
+
+    for(; end - p >= dlen; p++)  {
+        if(! (p = (const char *)memchr(p, delim[0], end - p - dlen + 1)))
+            return NULL;
+        if(! memcmp(p + 1, delim + 1, dlen - 1))
+            return p;
+    }
+    return NULL;
+}
+
+/*
+ * next non-empty item in [@p, @end), NULL if none, consecutive
+ * delimiters are skipped.
+ */
+static inline const char *__list_next(const char *p, const char *end,
+                                      const char *delim, size_t dlen, size_t *len)
+{
+    const char *_p;
+
+    for(; p < end; p = _p + dlen)  {
+        if(! (_p = __delim_find(p, end, delim, dlen)))
+            _p = end;
+        if(_p != p)  {
+            *len = _p - p;
+            return p;
+        }
+        if(_p == end)
+            break;
+    }
+    return NULL;
+}
+
+#define __SPLIT_STACK_ITEMS 32
+
 char **tiny_string_list_split(const char *list, const char *delim, int *num)
 {
-    const char *_delim = ",", *p, *_p;
+    struct { const char *p; size_t len; } _items[__SPLIT_STACK_ITEMS], *items = _items, *tmp;
+    const char *_delim = ",", *p, *end;
     char **array, **item, *content;
-    unsigned int l, len;
-    int cnt;
+    size_t l, dlen, sz = 0;
+    int cnt, cap = __SPLIT_STACK_ITEMS, i;
 
     if(! list || ! list[0])
         return NULL;
@@ -1203,37 +4227,86 @@ char **tiny_string_list_split(const char *list, const char *delim, int *num)
     if(! delim || ! delim[0])
         delim = _delim;
 
-    for(cnt = 0, p = _p = list, len = strlen(delim); _p && *p; p = _p + len) {
-        if(p != (_p = strstr(p, delim)))
-            cnt++;
+    /* one scan, remember items and the exact content size */
+    for(cnt = 0, p = list, end = list + strlen(list), dlen = strlen(delim);
+        (p = __list_next(p, end, delim, dlen, &l));
+        p += l)  {
+        if(cnt == cap)  {
+            tmp = (items == _items) ? malloc(sizeof(*items) * cap * 2)
+                : realloc(items, sizeof(*items) * cap * 2);
+            if(! tmp)  {
+                if(items != _items)
+                    free(items);
+                return NULL;
+            }
+            if(items == _items)
+                memcpy(tmp, _items, sizeof(_items));
+            items = tmp;
+            cap *= 2;
+        }
+        items[cnt].p = p;
+        items[cnt].len = l;
+        sz += l + 1;
+        cnt++;
     }
 
     /* reside in a single block with last NULL item */
-    if(! (array = (char **)malloc(strlen(list) + sizeof(char *) * (cnt + 1))))
-        return NULL;
-
-    item = array;
-    content = (char *)(array + cnt + 1);
-    for(p = _p = list; _p && *p; p = _p + len) {
-        if(p != (_p = strstr(p, delim))) {
-            if(_p) {
-                l = _p - p;
-                *item++ = strncpy(content, p, l);
-                content += l;
-                *content++ = '\0';
-            } else {
-                *item++ = strcpy(content, p);
-            }
+    if((array = (char **)malloc(sz + sizeof(char *) * (cnt + 1))))  {
+        item = array;
+        content = (char *)(array + cnt + 1);
+        for(i = 0; i < cnt; i++)  {
+            *item++ = memcpy(content, items[i].p, items[i].len);
+            content += items[i].len;
+            *content++ = '\0';
         }
-    }
+        *item = NULL;
 
-    *item = NULL;
-    if(num)
-        *num = cnt;
+        if(num)
+            *num = cnt;
+    }
 
+    if(items != _items)
+        free(items);
     return array;
 }
 
+void tiny_string_list_iter_init(struct tiny_string_list_iter *iter, const char *list, const char *delim)
+{
+    if(! iter)
+        return;
+
+    if(! delim || ! delim[0])
+        delim = ",";
+
+    iter->cur = list ? list : "";
+    iter->end = iter->cur + strlen(iter->cur);
+    iter->delim = delim;
+    iter->dlen = strlen(delim);
+}
+
+/*
+ * returns next non-empty item of the list, not NUL terminated, with
+ * its length in @len, NULL at end of list.
+ */
+const char *tiny_string_list_iter_next(struct tiny_string_list_iter *iter, size_t *len)
+{
+    const char *p;
+    size_t l;
+
+    if(! iter || ! iter->cur)
+        return NULL;
+
+    if(! (p = __list_next(iter->cur, iter->end, iter->delim, iter->dlen, &l)))  {
+        iter->cur = NULL;
+        return NULL;
+    }
+
+    iter->cur = p + l;
+    if(len)
+        *len = l;
+    return p;
+}
+
 /*
  * @size: list capacity, including terminating '\0'
  */
@@ -1352,8 +4425,313 @@ int tiny_string_list_concat(char *list, const char *delim, unsigned int size, co
     return res;
 }
 
+/*
+ * string set: items interned in a byte arena in insertion order, each
+ * as [u32 length][bytes]['\0'], indexed by an open addressing hash of
+ * arena offsets. removed items become tombstones in both, the arena is
+ * compacted once more than half of it is dead.
+ */
+#define SET_DEAD        0x80000000U
+#define SET_EMPTY       0xFFFFFFFFU
+#define SET_TOMBSTONE   0xFFFFFFFEU
+#define SET_INIT_SLOTS  16
+
+struct set_slot {
+    uint32_t hash;
+    uint32_t off;
+};
+
+struct tiny_string_set {
+    unsigned char *arena;
+    size_t len, cap, dead;
+    struct set_slot *slots;
+    unsigned int mask, used, filled;
+};
+
+/* FNV-1a */
+static inline uint32_t __set_hash(const char *s, size_t len)
+{
+    uint32_t h = 2166136261U;
+
+    while(len--)  {
+        h ^= (unsigned char)*s++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+static inline uint32_t __set_item_len(const tiny_string_set *set, uint32_t off)
+{
+    uint32_t l;
+
+    memcpy(&l, set->arena + off, sizeof(l));
+    return l;
+}
+
+static inline size_t __set_item_size(uint32_t len)
+{
+    return sizeof(uint32_t) + (len & ~SET_DEAD) + 1;
+}
+
+/* slot holding @item, or the slot it should be inserted in */
+static struct set_slot *__set_lookup(const tiny_string_set *set, const char *item,
+                                     size_t len, uint32_t hash)
+{
+    struct set_slot *slot, *free_slot = NULL;
+    unsigned int i;
+
+    for(i = hash & set->mask;; i = (i + 1) & set->mask)  {
+        slot = &set->slots[i];
+        if(slot->off == SET_EMPTY)
+            return free_slot ? : slot;
+        if(slot->off == SET_TOMBSTONE)  {
+            if(! free_slot)
+                free_slot = slot;
+            continue;
+        }
+        if(slot->hash == hash && __set_item_len(set, slot->off) == len &&
+           ! memcmp(set->arena + slot->off + sizeof(uint32_t), item, len))
+            return slot;
+    }
+}
+
+/* rebuild index with @nslots slots, dropping tombstones and dead items */
+static int __set_rehash(tiny_string_set *set, unsigned int nslots)
+{
+    struct set_slot *slots, *slot;
+    unsigned char *arena = set->arena;
+    size_t off, len = 0;
+    uint32_t l, hash;
+
+    if(! (slots = (struct set_slot *)malloc(sizeof(*slots) * nslots)))
+        return -1;
+
+    memset(slots, 0xFF, sizeof(*slots) * nslots);
+    free(set->slots);
+    set->slots = slots;
+    set->mask = nslots - 1;
+    set->filled = set->used;
+
+    for(off = 0; off < set->len; off += __set_item_size(l))  {
+        memcpy(&l, arena + off, sizeof(l));
+        if(l & SET_DEAD)
+            continue;
+
+        if(off != len)
+            memmove(arena + len, arena + off, __set_item_size(l));
+
+        hash = __set_hash((const char *)arena + len + sizeof(uint32_t), l);
+        slot = __set_lookup(set, (const char *)arena + len + sizeof(uint32_t), l, hash);
+        slot->hash = hash;
+        slot->off = len;
+        len += __set_item_size(l);
+    }
+
+    set->len = len;
+    set->dead = 0;
+    return 0;
+}
+
+static int __set_insert(tiny_string_set *set, const char *item, size_t len)
+{
+    struct set_slot *slot;
+    unsigned char *arena;
+    uint32_t hash, l = len;
+    size_t need, cap;
+    unsigned int nslots;
+
+    if(! len || len >= SET_DEAD)
+        return -1;
+
+    /* keep load factor including tombstones under 3/4 */
+    if((set->filled + 1) * 4 > (set->mask + 1) * 3)  {
+        for(nslots = set->mask + 1; (set->used + 1) * 2 > nslots; nslots *= 2)
+            ;
+        if(__set_rehash(set, nslots))
+            return -1;
+    }
+
+    hash = __set_hash(item, len);
+    slot = __set_lookup(set, item, len, hash);
+    if(slot->off != SET_EMPTY && slot->off != SET_TOMBSTONE)
+        return 0;
+
+    need = set->len + __set_item_size(l);
+    if(need > set->cap)  {
+        for(cap = set->cap ? : 256; cap < need; cap *= 2)
+            ;
+        if(cap > SET_TOMBSTONE || ! (arena = (unsigned char *)realloc(set->arena, cap)))
+            return -1;
+        set->arena = arena;
+        set->cap = cap;
+    }
+
+    memcpy(set->arena + set->len, &l, sizeof(l));
+    memcpy(set->arena + set->len + sizeof(l), item, len);
+    set->arena[need - 1] = '\0';
+
+    if(slot->off == SET_EMPTY)
+        set->filled++;
+    slot->hash = hash;
+    slot->off = set->len;
+    set->len = need;
+    set->used++;
+    return 0;
+}
+
+static int __set_add_list(tiny_string_set *set, const char *list, const char *delim)
+{
+    const char *p, *end;
+    size_t l, dlen;
+
+    if(! delim || ! delim[0])
+        delim = ",";
+
+    for(p = list, end = list + strlen(list), dlen = strlen(delim);
+        (p = __list_next(p, end, delim, dlen, &l));
+        p += l)  {
+        if(__set_insert(set, p, l))
+            return -1;
+    }
+    return 0;
+}
+
+/*
+ * parse a delimited @list once, NULL @list for an empty set, empty
+ * items skipped as tiny_string_list_split() does.
+ */
+tiny_string_set *tiny_string_set_new(const char *list, const char *delim)
+{
+    tiny_string_set *set = (tiny_string_set *)calloc(1, sizeof(*set));
+
+    if(! set)
+        return NULL;
+
+    if(__set_rehash(set, SET_INIT_SLOTS) ||
+       (list && __set_add_list(set, list, delim)))  {
+        tiny_string_set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+void tiny_string_set_free(tiny_string_set *set)
+{
+    if(set)  {
+        free(set->arena);
+        free(set->slots);
+        free(set);
+    }
+}
+
+unsigned int tiny_string_set_count(const tiny_string_set *set)
+{
+    return set ? set->used : 0;
+}
+
+int tiny_string_set_insert(tiny_string_set *set, const char *item)
+{
+    if(! set || ! item || ! item[0])
+        return -1;
+
+    return __set_insert(set, item, strlen(item));
+}
+
+int tiny_string_set_remove(tiny_string_set *set, const char *item)
+{
+    struct set_slot *slot;
+    uint32_t l;
+    size_t len;
+
+    if(! set || ! item || ! item[0])
+        return -1;
+
+    len = strlen(item);
+    slot = __set_lookup(set, item, len, __set_hash(item, len));
+    if(slot->off == SET_EMPTY || slot->off == SET_TOMBSTONE)
+        return 0;
+
+    l = len | SET_DEAD;
+    memcpy(set->arena + slot->off, &l, sizeof(l));
+    set->dead += __set_item_size(l);
+    slot->off = SET_TOMBSTONE;
+    set->used--;
+
+    if(set->dead > 4096 && set->dead * 2 > set->len)
+        return __set_rehash(set, set->mask + 1);
+    return 0;
+}
+
+int tiny_string_set_find(const tiny_string_set *set, const char *item)
+{
+    struct set_slot *slot;
+    size_t len;
+
+    if(! set || ! item || ! item[0])
+        return -1;
+
+    len = strlen(item);
+    slot = __set_lookup(set, item, len, __set_hash(item, len));
+    return (slot->off == SET_EMPTY || slot->off == SET_TOMBSTONE) ? -1 : 0;
+}
+
+int tiny_string_set_concat(tiny_string_set *set, const char *delim, const char *add)
+{
+    if(! set || ! add)
+        return -1;
+
+    return __set_add_list(set, add, delim);
+}
+
+/*
+ * serialize back to delimited list in insertion order.
+ * @size: list capacity, including terminating '\0'
+ * returns the list length, or the length needed if @list is NULL,
+ * -1 if @size is too small.
+ */
+int tiny_string_set_serialize(const tiny_string_set *set, const char *delim,
+                              char *list, unsigned int size)
+{
+    size_t off, len = 0, dlen;
+    uint32_t l;
+
+    if(! set)
+        return -1;
+
+    if(! delim || ! delim[0])
+        delim = ",";
+    dlen = strlen(delim);
+
+    for(off = 0; off < set->len; off += __set_item_size(l))  {
+        l = __set_item_len(set, off);
+        if(l & SET_DEAD)
+            continue;
+
+        if(list)  {
+            if(len + (len ? dlen : 0) + l + 1 > size)
+                return -1;
+            if(len)  {
+                memcpy(list + len, delim, dlen);
+                len += dlen;
+            }
+            memcpy(list + len, set->arena + off + sizeof(uint32_t), l);
+        } else if(len)  {
+            len += dlen;
+        }
+        len += l;
+    }
+
+    if(list)  {
+        if(! size)
+            return -1;
+        list[len] = '\0';
+    }
+    return len;
+}
+
 static __attribute__((unused)) void __build_check(void)
 {
-    BUILD_FAIL_IF(128 != ARRAYSIZE(gsm_alphabet));
+    BUILD_FAIL_IF(4 != sizeof(struct gsm_char));
+    BUILD_FAIL_IF(128 != ARRAYSIZE(gsm_tables[0]));
 }
 
@@ -21,15 +21,25 @@
 #ifndef __TINYCODE_H
 #define __TINYCODE_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define UTF_CODING_INVALID  (-1)
 #define UTF_CODING_UTF8     0
 #define UTF_CODING_UTF16BE  1
 #define UTF_CODING_UTF16LE  2
 #define UTF_CODING_UTF32    3
+#define UTF_CODING_LATIN1   4   /* ISO-8859-1 */
+#define UTF_CODING_CP1252   5   /* Windows-1252 */
+#define UTF_CODING_ASCII    6
 
 #define UTF_CODING_UTF8_NAME    "UTF8"
 #define UTF_CODING_UTF16BE_NAME "UTF16BE"
 #define UTF_CODING_UTF16LE_NAME "UTF16LE"
+#define UTF_CODING_LATIN1_NAME  "LATIN1"
+#define UTF_CODING_CP1252_NAME  "CP1252"
+#define UTF_CODING_ASCII_NAME   "ASCII"
 
 #if defined(__BYTE_ORDER)
  #if __BYTE_ORDER == __BIG_ENDIAN
@@ -41,18 +51,70 @@
  #endif
 #endif
 
+#define UTF_CONV_REPLACE        1       /* substitute invalid input instead of failing */
+#define UTF_REPLACEMENT_CHAR    0xFFFD
+
 #define UTF_ERR_OK          0
 #define UTF_ERR_BAD_ARG     (-1)
 #define UTF_ERR_INCOMPLETE  (-2)
 #define UTF_ERR_BAD_CODE    (-3)
 #define UTF_ERR_SIZE        (-4)
 #define UTF_ERR_NO_SUPPORT  (-5)
+#define UTF_ERR_UNMAPPABLE  (-6)    /* no such character in the target coding */
 
 #define LANG_SHIFT_GSM7BIT      0x00
 #define LANG_SHIFT_TURKISH      0x01
 #define LANG_SHIFT_SPANISH      0x02
 #define LANG_SHIFT_PORTUGUESE   0x03
+#define LANG_SHIFT_BENGALI      0x04
+#define LANG_SHIFT_GUJARATI     0x05
+#define LANG_SHIFT_HINDI        0x06
+#define LANG_SHIFT_KANNADA      0x07
+#define LANG_SHIFT_MALAYALAM    0x08
+#define LANG_SHIFT_ORIYA        0x09
+#define LANG_SHIFT_PUNJABI      0x0A
+#define LANG_SHIFT_TAMIL        0x0B
+#define LANG_SHIFT_TELUGU       0x0C
+#define LANG_SHIFT_URDU         0x0D
+#define LANG_SHIFT_MAX          0x0E
+
+
+/* instrumentation, compiled in unless TINYCODE_NO_STATS, off by default */
+#define TINY_STAT_UTF_CONVERT       0
+#define TINY_STAT_UTF_TO_UTF8       1
+#define TINY_STAT_UCS16BE           2
+#define TINY_STAT_UNICODE           3
+#define TINY_STAT_ASC7BIT_PACKED    4
+#define TINY_STAT_ASC7BIT_UNPACKED  5
+#define TINY_STAT_GSM7BIT           6
+#define TINY_STAT_GSM8BIT           7
+#define TINY_STAT_UCS2              8
+#define TINY_STAT_ADN               9
+#define TINY_STAT_ADN_EF            10
+#define TINY_STAT_IP_ADDR           11
+#define TINY_STAT_BCD_NUM           12
+#define TINY_STAT_HEX               13
+#define TINY_STAT_MAX               14
+
+#define TINY_STAT_HIST_BUCKETS      32  /* bucket n: [2^n, 2^(n+1)) ns */
+#define TINY_STAT_ERRORS            7   /* indexed by -UTF_ERR_* */
 
+struct tiny_stat_entry {
+    unsigned long calls;
+    unsigned long bytes_in;
+    unsigned long bytes_out;
+    unsigned long regrows;      /* output reallocations, TINY_STAT_UTF_TO_UTF8 only */
+    unsigned long hist[TINY_STAT_HIST_BUCKETS];
+};
+
+struct tiny_stats {
+    struct tiny_stat_entry entry[TINY_STAT_MAX];
+    unsigned long errors[TINY_STAT_ERRORS];
+};
+
+extern void tiny_stats_enable(int enable);
+extern int tiny_stats_snapshot(struct tiny_stats *stats);
+extern const char *tiny_stats_name(int id);
 
 /* basic */
 extern int tiny_decode_hex(char c);
@@ -61,26 +123,257 @@ extern char *tiny_encode_hex_string(const char *str, int len);
 extern void tiny_hex_dump(int tabs, const char *val, int len);
 
 /* UTF handling */
+extern int tiny_utf_coding_id(const char *name);
 extern int tiny_utf_convert(int from, void **in, size_t *in_sz,
                             int to, void **out, size_t *out_sz);
+extern int tiny_utf_convert_ex(int from, void **in, size_t *in_sz,
+                               int to, void **out, size_t *out_sz,
+                               int flags, unsigned int subst, size_t *nsubst);
 extern int tiny_utf_convert_name(const char *from, void **in, size_t *in_sz,
                                  const char *to, void **out, size_t *out_sz);
+extern int tiny_utf_convert_parallel(int from, void **in, size_t *in_sz,
+                                     int to, void **out, size_t *out_sz, int threads);
+extern void tiny_utf_parallel_shutdown(void);
+extern int tiny_utf_detect(const void *buf, size_t len, int *confidence, size_t *bom);
+extern int tiny_utf16_swap(int from, void **in, size_t *in_sz,
+                           void **out, size_t *out_sz, int validate);
+
+/* byte offset of every stride-th code point of a UTF8 text */
+struct tiny_utf8_index {
+    const char *text;
+    size_t len;
+    size_t count;               /* code points */
+    unsigned int stride;
+    size_t nr;
+    size_t *off;                /* off[i]: code point i * stride, same allocation */
+};
+
+extern size_t tiny_utf8_count(const char *text, size_t len);
+extern size_t tiny_utf8_skip(const char *text, size_t len, size_t k);
+extern struct tiny_utf8_index *tiny_utf8_index_new(const char *text, size_t len, unsigned int stride);
+extern size_t tiny_utf8_index_offset(const struct tiny_utf8_index *idx, size_t k);
 extern char *tiny_utf_to_utf8(const char *text, int len, int coding);
+extern char *tiny_utf_to_utf8_range(const char *text, int len, int coding,
+                                    int max_chars, int max_bytes, int *next);
+
+/*
+ * code point iterator, inlined into the caller's loop. the checked
+ * _next() return bytes consumed, 0 at the end, or UTF_ERR_INCOMPLETE
+ * or UTF_ERR_BAD_CODE leaving @it in place, validating as
+ * tiny_utf_convert() does. the _unchecked ones trust the text to be
+ * valid with bytes left, for text already validated.
+ */
+struct tiny_utf_iter {
+    const unsigned char *p;
+    const unsigned char *end;
+};
+
+static inline void tiny_utf_iter_init(struct tiny_utf_iter *it, const void *text, size_t len)
+{
+    it->p = (const unsigned char *)text;
+    it->end = it->p + len;
+}
+
+static inline size_t tiny_utf_iter_left(const struct tiny_utf_iter *it)
+{
+    return it->end - it->p;
+}
+
+static inline int tiny_utf8_next(struct tiny_utf_iter *it, unsigned int *cp)
+{
+    const unsigned char *p = it->p;
+    size_t left = it->end - p;
+    unsigned char lo = 0x80, hi = 0xBF;
+    unsigned int c;
+    int n, i;
+
+    if(! left)
+        return 0;
+    if(*p < 0x80)  {
+        *cp = *p;
+        it->p++;
+        return 1;
+    }
+
+    /* no overlong forms, surrogates or anything above 0x10FFFF */
+    if(*p < 0xC2 || *p > 0xF4)
+        return UTF_ERR_BAD_CODE;
+    n = *p < 0xE0 ? 2 : *p < 0xF0 ? 3 : 4;
+    if(*p == 0xE0)
+        lo = 0xA0;
+    else if(*p == 0xED)
+        hi = 0x9F;
+    else if(*p == 0xF0)
+        lo = 0x90;
+    else if(*p == 0xF4)
+        hi = 0x8F;
+    if(left < 2)
+        return UTF_ERR_INCOMPLETE;
+    if(p[1] < lo || p[1] > hi)
+        return UTF_ERR_BAD_CODE;
+    for(i = 2; i < n; i++)  {
+        if((size_t)i >= left)
+            return UTF_ERR_INCOMPLETE;
+        if((p[i] & 0xC0) != 0x80)
+            return UTF_ERR_BAD_CODE;
+    }
+
+    c = *p & (0x7F >> n);
+    for(i = 1; i < n; i++)
+        c = (c << 6) | (p[i] & 0x3F);
+    *cp = c;
+    it->p += n;
+    return n;
+}
+
+static inline unsigned int tiny_utf8_next_unchecked(struct tiny_utf_iter *it)
+{
+    const unsigned char *p = it->p;
+
+    if(p[0] < 0x80)  {
+        it->p += 1;
+        return p[0];
+    }
+    if(p[0] < 0xE0)  {
+        it->p += 2;
+        return (p[0] & 0x1F) << 6 | (p[1] & 0x3F);
+    }
+    if(p[0] < 0xF0)  {
+        it->p += 3;
+        return (p[0] & 0x0F) << 12 | (p[1] & 0x3F) << 6 | (p[2] & 0x3F);
+    }
+    it->p += 4;
+    return (p[0] & 0x07) << 18 | (p[1] & 0x3F) << 12 | (p[2] & 0x3F) << 6 | (p[3] & 0x3F);
+}
+
+static inline unsigned int __tiny_read16(const unsigned char *p, int be)
+{
+    return be ? (p[0] << 8 | p[1]) : (p[1] << 8 | p[0]);
+}
+
+static inline int __tiny_utf16_next(struct tiny_utf_iter *it, int be, unsigned int *cp)
+{
+    size_t left = it->end - it->p;
+    unsigned int hi, lo;
+
+    if(! left)
+        return 0;
+    if(left < 2)
+        return UTF_ERR_INCOMPLETE;
+
+    hi = __tiny_read16(it->p, be);
+    if(hi < 0xD800 || hi > 0xDFFF)  {
+        *cp = hi;
+        it->p += 2;
+        return 2;
+    }
+    if(hi > 0xDBFF)
+        return UTF_ERR_BAD_CODE;
+    if(left < 4)
+        return UTF_ERR_INCOMPLETE;
+    lo = __tiny_read16(it->p + 2, be);
+    if(lo < 0xDC00 || lo > 0xDFFF)
+        return UTF_ERR_BAD_CODE;
+
+    *cp = 0x10000 + ((hi - 0xD800) << 10) + (lo - 0xDC00);
+    it->p += 4;
+    return 4;
+}
+
+static inline unsigned int __tiny_utf16_next_unchecked(struct tiny_utf_iter *it, int be)
+{
+    unsigned int hi = __tiny_read16(it->p, be);
+
+    if(hi < 0xD800 || hi > 0xDBFF)  {
+        it->p += 2;
+        return hi;
+    }
+    it->p += 4;
+    return 0x10000 + ((hi - 0xD800) << 10) + (__tiny_read16(it->p - 2, be) - 0xDC00);
+}
+
+static inline int tiny_utf16be_next(struct tiny_utf_iter *it, unsigned int *cp)
+{
+    return __tiny_utf16_next(it, 1, cp);
+}
+
+static inline int tiny_utf16le_next(struct tiny_utf_iter *it, unsigned int *cp)
+{
+    return __tiny_utf16_next(it, 0, cp);
+}
+
+static inline unsigned int tiny_utf16be_next_unchecked(struct tiny_utf_iter *it)
+{
+    return __tiny_utf16_next_unchecked(it, 1);
+}
+
+static inline unsigned int tiny_utf16le_next_unchecked(struct tiny_utf_iter *it)
+{
+    return __tiny_utf16_next_unchecked(it, 0);
+}
+
+/* by UTF_CODING_*, folds to the one above when @coding is a constant */
+static inline int tiny_utf_next(struct tiny_utf_iter *it, int coding, unsigned int *cp)
+{
+    switch(coding)  {
+    case UTF_CODING_UTF8:
+        return tiny_utf8_next(it, cp);
+    case UTF_CODING_UTF16BE:
+        return tiny_utf16be_next(it, cp);
+    case UTF_CODING_UTF16LE:
+        return tiny_utf16le_next(it, cp);
+    }
+    return UTF_ERR_NO_SUPPORT;
+}
 
 /* GSM/CDMA coding handling */
 extern char *tiny_decode_ucs16be(const unsigned char *txt, int len);
 extern char *tiny_decode_unicode(const unsigned char *pdu, int len, int bitoffset);
 
 extern char *tiny_decode_asc7bit_packed(const unsigned char *pdu, int septets, int bitoffset);
+extern int tiny_decode_asc7bit_packed_r(const unsigned char *pdu, int septets, int bitoffset,
+                                        char *buf, size_t size);
 extern char *tiny_decode_asc7bit_unpacked(const unsigned char *pdu, int septets, int bitoffset);
 
+#define TINY_IPV4_ADDR_LEN      4
+#define TINY_IPV6_ADDR_LEN      16
+#define TINY_INET_ADDRSTRLEN    16
+#define TINY_INET6_ADDRSTRLEN   46
+
 extern char *tiny_decode_ip_addr(const unsigned char *pdu, int bitoffset);
+extern int tiny_decode_ip_addr_r(const unsigned char *pdu, int bitoffset, int alen,
+                                 char *buf, size_t size, unsigned char *bin);
 
 extern char *tiny_decode_gsm7bit_packed_ex(const unsigned char *pdu, int septets, int padingbits,
                                            int single_shift, int locking_shift);
 extern char *tiny_decode_gsm8bit_unpacked_ex(const unsigned char *pdu, int len,
                                              int single_shift, int locking_shift);
 
+/*
+ * decode from septet @start on, at most @max_chars characters or
+ * @max_bytes bytes of UTF-8, negative for no limit. escape sequences
+ * are never split, *@next gets the septet to resume from.
+ */
+extern char *tiny_decode_gsm7bit_packed_range(const unsigned char *pdu, int septets, int padingbits,
+                                              int start, int max_chars, int max_bytes,
+                                              int single_shift, int locking_shift, int *next);
+extern char *tiny_decode_gsm8bit_unpacked_range(const unsigned char *pdu, int len, int start,
+                                                int max_chars, int max_bytes,
+                                                int single_shift, int locking_shift, int *next);
+
+#define GSM_ENC_TRANSLIT    1   /* transliterate characters no shift table has */
+
+/* returns septets written, -2 if @text needs UCS2 */
+extern int tiny_encode_gsm7bit_packed_r(const char *text, int len, int padingbits,
+                                        int single_shift, int locking_shift, int flags,
+                                        unsigned char *pdu, size_t size);
+
+/* into caller buffer, @size at least 3 * septets + 1, returns bytes written */
+extern int tiny_decode_gsm7bit_packed_r(const unsigned char *pdu, int septets, int padingbits,
+                                        int single_shift, int locking_shift, char *buf, size_t size);
+extern int tiny_decode_gsm8bit_unpacked_r(const unsigned char *pdu, int len,
+                                          int single_shift, int locking_shift, char *buf, size_t size);
+
 static char *tiny_decode_gsm7bit_packed(const unsigned char *pdu, int septets, int padingbits)
 {
     return tiny_decode_gsm7bit_packed_ex(pdu, septets, padingbits,
@@ -93,9 +386,93 @@ static char *tiny_decode_gsm8bit_unpacked(const unsigned char *pdu, int len)
                                            LANG_SHIFT_GSM7BIT, LANG_SHIFT_GSM7BIT);
 }
 
+/*
+ * memoizing decode cache, byte identical payloads decoded with the same
+ * parameters share one refcounted UTF-8 result. thread safe, sized at
+ * creation and never grown, least recently used entries are evicted.
+ */
+typedef struct tiny_decode_cache tiny_decode_cache;
+
+struct tiny_decode_cache_stats {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+    unsigned int entries;
+    unsigned int capacity;
+};
+
+extern tiny_decode_cache *tiny_decode_cache_new(unsigned int entries);
+extern void tiny_decode_cache_free(tiny_decode_cache *cache);
+extern const char *tiny_decode_cache_gsm7bit_packed(tiny_decode_cache *cache, const unsigned char *pdu,
+                                                    int septets, int padingbits,
+                                                    int single_shift, int locking_shift);
+extern const char *tiny_decode_cache_ucs16be(tiny_decode_cache *cache, const unsigned char *txt, int len);
+extern void tiny_decode_cache_release(const char *str);
+extern void tiny_decode_cache_stats(tiny_decode_cache *cache, struct tiny_decode_cache_stats *st);
+
+/* cell broadcast pages, TS 23.041 */
+#define CBS_PAGE_SIZE       88
+#define CBS_CONTENT_SIZE    82
+
+#define CBS_CODING_GSM7     0
+#define CBS_CODING_8BIT     1
+#define CBS_CODING_UCS2     2
+
+struct tiny_cbs_page {
+    unsigned int serial;
+    unsigned int msg_id;
+    unsigned int dcs;
+    int coding;                 /* CBS_CODING_* */
+    int page;                   /* 1 based */
+    int pages;
+    int lang_prefix;            /* content led by the language */
+    int udh;                    /* content led by a user data header */
+    char lang[3];               /* ISO 639, empty if not known */
+    const unsigned char *content;
+};
+
+/* one single allocation, free() it */
+struct tiny_cbs_message {
+    unsigned int serial;
+    unsigned int msg_id;
+    unsigned int dcs;
+    int coding;
+    int pages;
+    char lang[3];
+    size_t len;
+    char *text;                 /* UTF-8, raw octets for CBS_CODING_8BIT, same allocation */
+};
+
+/* reassembles multi-page messages and drops repeats, not thread safe */
+typedef struct tiny_cbs_assembler tiny_cbs_assembler;
+
+extern int tiny_cbs_page_parse(const unsigned char *pdu, int len, struct tiny_cbs_page *page);
+extern struct tiny_cbs_message *tiny_decode_cbs_page(const unsigned char *pdu, int len);
+extern tiny_cbs_assembler *tiny_cbs_assembler_new(unsigned int seen);
+extern void tiny_cbs_assembler_free(tiny_cbs_assembler *cbs);
+extern int tiny_cbs_assembler_feed(tiny_cbs_assembler *cbs, const unsigned char *pdu, int len,
+                                   struct tiny_cbs_message **msg);
+
+/* USSD strings, CBS data coding scheme, into caller buffers */
+extern int tiny_decode_ussd_r(const unsigned char *pdu, int len, int dcs, char *buf, size_t size,
+                              char *lang);
+extern int tiny_encode_ussd_r(const char *text, int len, int dcs, const char *lang,
+                              unsigned char *pdu, size_t size);
+
 
-extern char *tiny_decode_ucs2(const char *pdu, char base, int len);
+extern char *tiny_decode_ucs2(const char *pdu, unsigned int base, int len);
 extern char *tiny_decode_adn(const unsigned char *pdu, int len);
+extern int tiny_decode_adn_r(const unsigned char *pdu, int len, char *buf, size_t size);
+
+struct tiny_adn_record {
+    int index;                  /* record number, 1 based */
+    char *alpha;
+    char *number;
+};
+
+/* decode every used record of an EF_ADN image into one single block */
+extern struct tiny_adn_record *tiny_decode_adn_ef(const unsigned char *ef, int len,
+                                                  int reclen, int *num);
 
 extern int tiny_decode_bcd(unsigned char pdu);
 extern int tiny_decode_bcd_cdma(unsigned char pdu);
@@ -111,13 +488,44 @@ extern unsigned char *tiny_decode_bcd_num_cdma(const unsigned char *pdu, int sz,
 #define TRIM_ALL         (TRIM_FRONT | TRIM_MIDDLE | TRIM_END)
 
 extern char *tiny_string_trim(char *string, const char *junk, int flag);
+extern const char *tiny_string_trim_view(const char *string, const char *junk, size_t *len);
 /* note: space isn't exluded during comparing, trim them before
    passing them into the functions */
 extern char **tiny_string_list_split(const char *list, const char *delim, int *num);
+
+/* zero copy iterating over items of a list, list not modified */
+struct tiny_string_list_iter {
+    const char *cur;
+    const char *end;
+    const char *delim;
+    size_t dlen;
+};
+
+extern void tiny_string_list_iter_init(struct tiny_string_list_iter *iter,
+                                       const char *list, const char *delim);
+extern const char *tiny_string_list_iter_next(struct tiny_string_list_iter *iter, size_t *len);
+
 extern int tiny_string_list_insert(char *list, const char *delim, unsigned int size, const char *item);
 extern int tiny_string_list_remove(char *list, const char *delim, const char *item);
 extern int tiny_string_list_find(char *list, const char *delim, const char *item);
 extern int tiny_string_list_concat(char *list, const char *delim, unsigned int size, const char *add);
+
+/* hash indexed delimited list, O(1) find/insert/remove */
+typedef struct tiny_string_set tiny_string_set;
+
+extern tiny_string_set *tiny_string_set_new(const char *list, const char *delim);
+extern void tiny_string_set_free(tiny_string_set *set);
+extern unsigned int tiny_string_set_count(const tiny_string_set *set);
+extern int tiny_string_set_insert(tiny_string_set *set, const char *item);
+extern int tiny_string_set_remove(tiny_string_set *set, const char *item);
+extern int tiny_string_set_find(const tiny_string_set *set, const char *item);
+extern int tiny_string_set_concat(tiny_string_set *set, const char *delim, const char *add);
+extern int tiny_string_set_serialize(const tiny_string_set *set, const char *delim,
+                                     char *list, unsigned int size);
 /* utils */
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif  /* ! __TINYCODE_H */
@@ -0,0 +1,298 @@
+/*
+ * UTF/GSM/CDMA encoding conversion utils.
+ * Copyright (C) <2018>  Crs Chin<crs.chin@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * header only C++17 front-end, the coding pair or shift tables are
+ * template arguments so the C kernel is picked at compile time. output
+ * goes to a caller buffer or a reused std::string, which allocates
+ * only when its capacity falls short. still links with tinycode.c.
+ */
+#ifndef __TINYCODE_HPP
+#define __TINYCODE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include "tinycode.h"
+
+namespace tiny {
+
+enum class coding : int {
+    utf8 = UTF_CODING_UTF8,
+    utf16be = UTF_CODING_UTF16BE,
+    utf16le = UTF_CODING_UTF16LE,
+    latin1 = UTF_CODING_LATIN1,
+    cp1252 = UTF_CODING_CP1252,
+    ascii = UTF_CODING_ASCII,
+};
+
+/* @err one of UTF_ERR_*, @read and @written in bytes */
+struct result {
+    int err;
+    std::size_t read;
+    std::size_t written;
+    std::size_t replaced;
+
+    explicit operator bool() const { return err == UTF_ERR_OK; }
+};
+
+namespace detail {
+
+/* the C entry point of a coding pair, byte order swaps have their own */
+template<coding From, coding To>
+struct kernel {
+    static int run(void **in, std::size_t *in_sz, void **out, std::size_t *out_sz)
+    {
+        return tiny_utf_convert(static_cast<int>(From), in, in_sz, static_cast<int>(To), out, out_sz);
+    }
+};
+
+template<>
+struct kernel<coding::utf16be, coding::utf16le> {
+    static int run(void **in, std::size_t *in_sz, void **out, std::size_t *out_sz)
+    {
+        return tiny_utf16_swap(UTF_CODING_UTF16BE, in, in_sz, out, out_sz, 1);
+    }
+};
+
+template<>
+struct kernel<coding::utf16le, coding::utf16be> {
+    static int run(void **in, std::size_t *in_sz, void **out, std::size_t *out_sz)
+    {
+        return tiny_utf16_swap(UTF_CODING_UTF16LE, in, in_sz, out, out_sz, 1);
+    }
+};
+
+constexpr bool utf16(coding c)
+{
+    return c == coding::utf16be || c == coding::utf16le;
+}
+
+/*
+ * output bytes @n input bytes never exceed, @subst included: one per
+ * bad UTF8 byte or UTF16 unit, 4 bytes each above U+FFFF.
+ */
+template<coding From, coding To>
+constexpr std::size_t max_out(std::size_t n, unsigned int subst)
+{
+    if(subst > 0xFFFF && (To == coding::utf8 || utf16(To)))
+        return utf16(From) ? n * 2 : n * 4;
+    if constexpr(To == coding::utf8)
+        return utf16(From) ? n / 2 * 3 + 3 : n * 3;
+    else if constexpr(utf16(To))
+        return utf16(From) ? n + 2 : n * 2;
+    else
+        return n;               /* a byte per character or '?' */
+}
+
+template<coding From, coding To>
+inline result run(std::string_view in, char *out, std::size_t size, int flags, unsigned int subst)
+{
+    void *i = const_cast<char *>(in.data()), *o = out;
+    std::size_t isz = in.size(), osz = size, nsubst = 0;
+    int err;
+
+    if(flags & UTF_CONV_REPLACE)
+        err = tiny_utf_convert_ex(static_cast<int>(From), &i, &isz, static_cast<int>(To), &o, &osz,
+                                  flags, subst, &nsubst);
+    else
+        err = kernel<From, To>::run(&i, &isz, &o, &osz);
+    return {err, in.size() - isz, size - osz, nsubst};
+}
+
+} /* namespace detail */
+
+/*
+ * convert @in into @out of @size bytes, stops with UTF_ERR_SIZE when
+ * full, resume from result::read. @flags UTF_CONV_REPLACE substitutes
+ * bad input with @subst, U+FFFD if 0.
+ */
+template<coding From, coding To>
+inline result convert(std::string_view in, char *out, std::size_t size,
+                      int flags = 0, unsigned int subst = 0)
+{
+    return detail::run<From, To>(in, out, size, flags, subst);
+}
+
+/* replaces the content of @out, grown only if its capacity is short */
+template<coding From, coding To>
+inline result convert(std::string_view in, std::string &out, int flags = 0, unsigned int subst = 0)
+{
+    result res, more;
+
+    out.resize(out.capacity());
+    res = detail::run<From, To>(in, &out[0], out.size(), flags, subst);
+    /* one more round is enough, unless max_out() falls short */
+    while(res.err == UTF_ERR_SIZE)  {
+        out.resize(res.written + detail::max_out<From, To>(in.size() - res.read, subst));
+        more = detail::run<From, To>(in.substr(res.read), &out[res.written],
+                                     out.size() - res.written, flags, subst);
+        res.err = more.err;
+        res.read += more.read;
+        res.written += more.written;
+        res.replaced += more.replaced;
+    }
+    out.resize(res.written);
+    return res;
+}
+
+/* into the buffer of @reuse, moved in and out, on error up to the bad input */
+template<coding From, coding To>
+inline std::string convert(std::string_view in, std::string &&reuse = std::string(),
+                           int flags = 0, unsigned int subst = 0)
+{
+    std::string out(std::move(reuse));
+
+    convert<From, To>(in, out, flags, subst);
+    return out;
+}
+
+#if __cplusplus >= 202002L
+template<coding From, coding To>
+inline result convert(std::span<const unsigned char> in, std::span<char> out,
+                      int flags = 0, unsigned int subst = 0)
+{
+    return detail::run<From, To>(std::string_view(reinterpret_cast<const char *>(in.data()), in.size()),
+                                 out.data(), out.size(), flags, subst);
+}
+
+template<coding From, coding To>
+inline result convert(std::string_view in, std::span<char> out, int flags = 0, unsigned int subst = 0)
+{
+    return detail::run<From, To>(in, out.data(), out.size(), flags, subst);
+}
+#endif
+
+namespace gsm {
+
+#define GSM_TABLES_STORAGE  inline constexpr
+#include "gsm_tables.h"
+#undef GSM_TABLES_STORAGE
+
+/* gsm_tables rows of a LANG_SHIFT_* language, undefined for others */
+template<int Lang>
+struct language;
+
+#define TINY_LANG(lang, single_tbl, locking_tbl)                    \
+    template<>                                                      \
+    struct language<LANG_SHIFT_##lang> {                            \
+        static constexpr int single = GSM_TBL_##single_tbl;         \
+        static constexpr int locking = GSM_TBL_##locking_tbl;       \
+    };
+GSM_LANG_TABLES(TINY_LANG)
+#undef TINY_LANG
+
+/* the single and locking shift tables in use, known at compile time */
+template<int Single = LANG_SHIFT_GSM7BIT, int Locking = Single>
+struct alphabet {
+    static constexpr const gsm_char *single = gsm_tables[language<Single>::single];
+    static constexpr const gsm_char *locking = gsm_tables[language<Locking>::locking];
+
+    /* code point of septet @c, escaped if @esc, 0 if undefined */
+    static constexpr char32_t code_point(unsigned int c, bool esc = false)
+    {
+        const gsm_char &g = (esc ? single : locking)[c & 0x7F];
+
+        if(g.len & GSM_CHAR_UNDEF)
+            return 0;
+        if(g.len == 1)
+            return g.utf8[0];
+        if(g.len == 2)
+            return (g.utf8[0] & 0x1F) << 6 | (g.utf8[1] & 0x3F);
+        return (g.utf8[0] & 0x0F) << 12 | (g.utf8[1] & 0x3F) << 6 | (g.utf8[2] & 0x3F);
+    }
+
+    /* UTF-8 of septet @c, empty if undefined */
+    static std::string_view utf8(unsigned int c, bool esc = false)
+    {
+        const gsm_char &g = (esc ? single : locking)[c & 0x7F];
+
+        if(g.len & GSM_CHAR_UNDEF)
+            return std::string_view();
+        return std::string_view(reinterpret_cast<const char *>(g.utf8), g.len);
+    }
+
+    /*
+     * @septets after @padingbits of @pdu into @out, grown only if its
+     * capacity is short. returns bytes written, -1 if @pdu is short.
+     */
+    static int decode_packed(std::string_view pdu, int septets, int padingbits, std::string &out)
+    {
+        int n;
+
+        if(septets < 0 || padingbits < 0 ||
+           (std::size_t)padingbits + (std::size_t)septets * 7 > pdu.size() * 8)
+            return -1;
+        out.resize((std::size_t)septets * 3 + 1);
+        n = tiny_decode_gsm7bit_packed_r(reinterpret_cast<const unsigned char *>(pdu.data()), septets,
+                                         padingbits, Single, Locking, &out[0], out.size());
+        out.resize(n < 0 ? 0 : n);
+        return n;
+    }
+
+    static int decode_unpacked(std::string_view pdu, std::string &out)
+    {
+        int n;
+
+        out.resize(pdu.size() * 3 + 1);
+        n = tiny_decode_gsm8bit_unpacked_r(reinterpret_cast<const unsigned char *>(pdu.data()),
+                                           (int)pdu.size(), Single, Locking, &out[0], out.size());
+        out.resize(n < 0 ? 0 : n);
+        return n;
+    }
+
+    /*
+     * @text packed after @padingbits into @pdu, @flags GSM_ENC_*.
+     * returns septets, -1 if @pdu is short, -2 if @text needs UCS2.
+     */
+    static int encode_packed(std::string_view text, int padingbits, int flags,
+                             unsigned char *pdu, std::size_t size)
+    {
+        return tiny_encode_gsm7bit_packed_r(text.data(), (int)text.size(), padingbits,
+                                            Single, Locking, flags, pdu, size);
+    }
+
+    /* into @pdu, resized to the octets written */
+    static int encode_packed(std::string_view text, int padingbits, int flags, std::string &pdu)
+    {
+        int n;
+
+        /* a character takes 2 septets at most, transliterated 3 per 2 bytes */
+        pdu.assign((padingbits + text.size() * 2 * 7 + 7) / 8, '\0');
+        n = encode_packed(text, padingbits, flags, reinterpret_cast<unsigned char *>(&pdu[0]), pdu.size());
+        pdu.resize(n < 0 ? 0 : (padingbits + n * 7 + 7) / 8);
+        return n;
+    }
+};
+
+static_assert(alphabet<>::code_point(0x00) == U'@', "default alphabet");
+static_assert(alphabet<>::code_point(0x65, true) == U'€', "default extension");
+static_assert(alphabet<LANG_SHIFT_TURKISH>::code_point(0x07) == U'ı', "turkish locking");
+static_assert(alphabet<LANG_SHIFT_SPANISH>::locking == alphabet<>::locking, "spanish locking");
+
+} /* namespace gsm */
+
+} /* namespace tiny */
+
+#endif  /* ! __TINYCODE_HPP */
@@ -0,0 +1,465 @@
+/*
+ * command line transcoder and PDU decoder.
+ * Copyright (C) <2018>  Crs Chin<crs.chin@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tinycode.h"
+
+/* input slice converted per round, output sized for its worst case */
+#define SLICE_SIZE      (32 * 1024 * 1024)
+#define OUTBUF_SIZE     (1024 * 1024)
+
+struct input {
+    const unsigned char *data;
+    size_t len;
+    int mapped;
+};
+
+struct output {
+    int fd;
+    size_t len;
+    char buf[OUTBUF_SIZE];
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s -f FROM -t TO [-r CP] [-o OUT] [FILE]\n"
+            "       %s -d MODE [-s SINGLE] [-l LOCKING] [-b RECLEN] [-o OUT] [FILE]\n"
+            "\n"
+            "  -f, -t   transcode between UTF8, UTF16BE, UTF16LE, LATIN1, CP1252 and ASCII\n"
+            "  -r CP    replace invalid input with hex code point CP instead of\n"
+            "           failing, 0 for U+FFFD, also characters TO lacks, with\n"
+            "           '?' if CP is missing from TO too\n"
+            "  -d MODE  decode PDUs, one per line, MODE one of:\n"
+            "           gsm7   GSM 7 bit packed\n"
+            "           gsm8   GSM 7 bit unpacked\n"
+            "           ucs2   UCS2/UTF16 big endian\n"
+            "           asc7   CDMA 7 bit ascii packed\n"
+            "           adn    SIM alpha identifier\n"
+            "           cbs    cell broadcast pages, reassembled, repeats dropped\n"
+            "  -s, -l   GSM national language single/locking shift table\n"
+            "  -b       binary input of fixed RECLEN records instead of hex\n"
+            "           lines, hex lines may be prefixed with \"septets:\"\n",
+            prog, prog);
+}
+
+static int input_open(struct input *in, const char *path)
+{
+    struct stat st;
+    unsigned char *buf = NULL, *p;
+    size_t cap = 0;
+    ssize_t n;
+    int fd = 0;
+
+    memset(in, 0, sizeof(*in));
+    if(path && strcmp(path, "-") && (fd = open(path, O_RDONLY)) < 0)  {
+        fprintf(stderr, "unable to open \"%s\": %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    if(! fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0 &&
+       (p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED)  {
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        in->data = p;
+        in->len = st.st_size;
+        in->mapped = 1;
+    }
+
+    /* pipes, failed maps and procfs like files claiming 0 bytes, slurp */
+    while(! in->data)  {
+        if(in->len == cap)  {
+            cap = cap ? cap * 2 : OUTBUF_SIZE;
+            if(! (p = (unsigned char *)realloc(buf, cap)))  {
+                fprintf(stderr, "OOM reading input!\n");
+                free(buf);
+                return -1;
+            }
+            buf = p;
+        }
+        if((n = read(fd, buf + in->len, cap - in->len)) < 0)  {
+            if(errno == EINTR)
+                continue;
+            fprintf(stderr, "read error: %s\n", strerror(errno));
+            free(buf);
+            return -1;
+        }
+        if(! n && ! in->len)  {
+            free(buf);
+            in->data = (const unsigned char *)"";
+        }else if(! n)  {
+            in->data = buf;
+        }
+        in->len += n;
+    }
+
+    if(fd)
+        close(fd);
+    return 0;
+}
+
+static void input_close(struct input *in)
+{
+    if(in->mapped)
+        munmap((void *)in->data, in->len);
+    else if(in->len)
+        free((void *)in->data);
+}
+
+static int write_all(int fd, const void *data, size_t len)
+{
+    const char *p = (const char *)data;
+    ssize_t n;
+
+    while(len)  {
+        if((n = write(fd, p, len)) < 0)  {
+            if(errno == EINTR)
+                continue;
+            fprintf(stderr, "write error: %s\n", strerror(errno));
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int output_flush(struct output *out)
+{
+    int res = write_all(out->fd, out->buf, out->len);
+
+    out->len = 0;
+    return res;
+}
+
+/* ensure @len bytes free, returns the write position */
+static char *output_reserve(struct output *out, size_t len)
+{
+    if(out->len + len > sizeof(out->buf) && output_flush(out))
+        return NULL;
+    return out->buf + out->len;
+}
+
+/* step back so a slice never ends inside a code point */
+static size_t slice_end(const char *coding, const unsigned char *p, size_t len)
+{
+    size_t end = len;
+    unsigned int u;
+
+    if(! strcasecmp(coding, UTF_CODING_UTF8_NAME))  {
+        while(end > 0 && (p[end - 1] & 0xC0) == 0x80)
+            end--;
+        /* back to the lead byte, drop it too */
+        return (end > 0 && p[end - 1] >= 0xC0) ? end - 1 : len;
+    }
+    if(tiny_utf_coding_id(coding) >= UTF_CODING_LATIN1)
+        return len;
+
+    end &= ~(size_t)1;
+    if(end >= 2)  {
+        u = ! strcasecmp(coding, UTF_CODING_UTF16BE_NAME) ? (p[end - 2] << 8 | p[end - 1])
+            : (p[end - 2] | p[end - 1] << 8);
+        if(u >= 0xD800 && u <= 0xDBFF)
+            end -= 2;
+    }
+    return end;
+}
+
+/* @subst < 0 fails on invalid input, otherwise it is replaced with @subst */
+static int transcode(const struct input *in, const char *from, const char *to, int fd,
+                     long subst)
+{
+    unsigned char *obuf;
+    size_t off = 0, len, osz, n, nsubst = 0, ns;
+    void *i, *o;
+    int err = UTF_ERR_OK;
+
+    /*
+     * 3 bytes out per 2 in, or 2 per 1 from UTF8 to UTF16, CP1252 to
+     * UTF8 may go 3 per 1 but resumes on UTF_ERR_SIZE like substitutes
+     */
+    if(! (obuf = (unsigned char *)malloc(SLICE_SIZE * 2 + 16)))  {
+        fprintf(stderr, "OOM allocating output!\n");
+        return -1;
+    }
+
+    while(off < in->len)  {
+        len = in->len - off;
+        if(len > SLICE_SIZE)  {
+            len = slice_end(from, in->data + off, SLICE_SIZE);
+            if(! len)
+                len = SLICE_SIZE;
+        }
+
+        i = (void *)(in->data + off);
+        n = len;
+        o = obuf;
+        osz = SLICE_SIZE * 2 + 16;
+        if(subst < 0)  {
+            err = tiny_utf_convert_parallel(tiny_utf_coding_id(from), &i, &n,
+                                            tiny_utf_coding_id(to), &o, &osz, 0);
+        }else  {
+            err = tiny_utf_convert_ex(tiny_utf_coding_id(from), &i, &n,
+                                      tiny_utf_coding_id(to), &o, &osz,
+                                      UTF_CONV_REPLACE, (unsigned int)subst, &ns);
+            nsubst += ns;
+        }
+        /* the rest of a slice which outgrew the buffer goes next round */
+        if(err == UTF_ERR_SIZE && n < len)
+            err = UTF_ERR_OK;
+
+        if(write_all(fd, obuf, (unsigned char *)o - obuf))
+            break;
+
+        off += len - n;
+        if(err)  {
+            fprintf(stderr, "conversion failed at offset %zu: %d\n", off, err);
+            break;
+        }
+    }
+
+    if(nsubst)
+        fprintf(stderr, "%zu invalid or unmappable sequences replaced\n", nsubst);
+    free(obuf);
+    return err ? -1 : 0;
+}
+
+static tiny_cbs_assembler *cbs;
+
+/* one line per completed message, "msg_id serial: text" */
+static int decode_cbs(struct output *out, const unsigned char *pdu, int len)
+{
+    struct tiny_cbs_message *msg;
+    char *p;
+    int res = 0;
+
+    if(tiny_cbs_assembler_feed(cbs, pdu, len, &msg) <= 0)
+        return 0;
+
+    if((p = output_reserve(out, msg->len + 16)))
+        out->len += sprintf(p, "%04X %04X: %.*s\n", msg->msg_id, msg->serial, (int)msg->len, msg->text);
+    else
+        res = -1;
+    free(msg);
+    return res;
+}
+
+/* decode one PDU of @len octets into @out */
+static int decode_pdu(struct output *out, const char *mode, const unsigned char *pdu,
+                      int len, int septets, int single, int locking)
+{
+    size_t need;
+    char *p;
+    void *i, *o;
+    size_t isz, osz;
+    int n = -1;
+
+    if(! strcmp(mode, "cbs"))
+        return decode_cbs(out, pdu, len);
+
+    if(septets < 0)
+        septets = ! strcmp(mode, "gsm7") || ! strcmp(mode, "asc7") ? len * 8 / 7 : len;
+
+    need = (size_t)(septets > len ? septets : len) * 3 + 2;
+    if(need > sizeof(out->buf))  {
+        fprintf(stderr, "PDU of %d octets too long, skipped\n", len);
+        return 0;
+    }
+
+    if(! (p = output_reserve(out, need)))
+        return -1;
+
+    if(! strcmp(mode, "gsm7"))  {
+        if(septets > len * 8 / 7)
+            septets = len * 8 / 7;
+        n = tiny_decode_gsm7bit_packed_r(pdu, septets, 0, single, locking, p, need);
+    } else if(! strcmp(mode, "gsm8"))  {
+        n = tiny_decode_gsm8bit_unpacked_r(pdu, len, single, locking, p, need);
+    } else if(! strcmp(mode, "asc7"))  {
+        if(septets > len * 8 / 7)
+            septets = len * 8 / 7;
+        n = tiny_decode_asc7bit_packed_r(pdu, septets, 0, p, need);
+    } else if(! strcmp(mode, "adn"))  {
+        n = tiny_decode_adn_r(pdu, len, p, need);
+    } else if(! strcmp(mode, "ucs2"))  {
+        i = (void *)pdu;
+        isz = len & ~1;
+        o = p;
+        osz = need;
+        tiny_utf_convert(UTF_CODING_UTF16BE, &i, &isz, UTF_CODING_UTF8, &o, &osz);
+        n = (char *)o - p;
+    }
+
+    if(n < 0)
+        n = 0;
+    p[n++] = '\n';
+    out->len += n;
+    return 0;
+}
+
+static int decode_hex_lines(const struct input *in, const char *mode,
+                            int single, int locking, struct output *out)
+{
+    const unsigned char *p = in->data, *end = in->data + in->len, *eol, *q;
+    unsigned char *pdu = NULL, *tmp;
+    size_t cap = 0;
+    int len, septets, hi, lo;
+
+    for(; p < end; p = eol + 1)  {
+        if(! (eol = memchr(p, '\n', end - p)))
+            eol = end;
+
+        /* optional "septets:" prefix */
+        septets = -1;
+        for(q = p; q < eol && *q >= '0' && *q <= '9'; q++)
+            ;
+        if(q < eol && q > p && *q == ':')  {
+            septets = atoi((const char *)p);
+            p = q + 1;
+        }
+
+        if(cap < (size_t)(eol - p) / 2 + 1)  {
+            cap = (eol - p) / 2 + 1;
+            if(! (tmp = (unsigned char *)realloc(pdu, cap)))  {
+                fprintf(stderr, "OOM decoding!\n");
+                free(pdu);
+                return -1;
+            }
+            pdu = tmp;
+        }
+
+        for(len = 0; p + 1 < eol; p += 2)  {
+            if((hi = tiny_decode_hex(p[0])) < 0 || (lo = tiny_decode_hex(p[1])) < 0)
+                break;
+            pdu[len++] = hi << 4 | lo;
+        }
+
+        if(! len && septets < 0)
+            continue;
+
+        if(decode_pdu(out, mode, pdu, len, septets, single, locking))  {
+            free(pdu);
+            return -1;
+        }
+    }
+
+    free(pdu);
+    return 0;
+}
+
+static int decode_records(const struct input *in, const char *mode, int reclen,
+                          int single, int locking, struct output *out)
+{
+    size_t off;
+
+    for(off = 0; off + reclen <= in->len; off += reclen)  {
+        if(decode_pdu(out, mode, in->data + off, reclen, -1, single, locking))
+            return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *from = NULL, *to = NULL, *mode = NULL, *path = NULL, *opath = NULL;
+    struct output *out;
+    struct input in;
+    int i, reclen = 0, single = 0, locking = 0, res;
+    long subst = -1;
+
+    for(i = 1; i < argc; i++)  {
+        if(argv[i][0] != '-' || ! argv[i][1])  {
+            path = argv[i];
+            continue;
+        }
+        if(i + 1 >= argc || argv[i][2])  {
+            usage(argv[0]);
+            return 1;
+        }
+
+        switch(argv[i][1])  {
+        case 'f': from = argv[++i]; break;
+        case 't': to = argv[++i]; break;
+        case 'd': mode = argv[++i]; break;
+        case 'o': opath = argv[++i]; break;
+        case 's': single = atoi(argv[++i]); break;
+        case 'l': locking = atoi(argv[++i]); break;
+        case 'b': reclen = atoi(argv[++i]); break;
+        case 'r': subst = strtol(argv[++i], NULL, 16); break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if(! mode && (! from || ! to || tiny_utf_coding_id(from) == UTF_CODING_INVALID ||
+                  tiny_utf_coding_id(to) == UTF_CODING_INVALID))  {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if(mode && strcmp(mode, "gsm7") && strcmp(mode, "gsm8") && strcmp(mode, "ucs2") &&
+       strcmp(mode, "asc7") && strcmp(mode, "adn") && strcmp(mode, "cbs"))  {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if(! (out = (struct output *)malloc(sizeof(*out))))  {
+        fprintf(stderr, "OOM allocating output!\n");
+        return 1;
+    }
+    out->len = 0;
+    out->fd = 1;
+    if(opath && (out->fd = open(opath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)  {
+        fprintf(stderr, "unable to open \"%s\": %s\n", opath, strerror(errno));
+        return 1;
+    }
+
+    if(input_open(&in, path))
+        return 1;
+
+    if(mode && ! strcmp(mode, "cbs") && ! (cbs = tiny_cbs_assembler_new(4096)))
+        return 1;
+
+    if(! mode)
+        res = transcode(&in, from, to, out->fd, subst);
+    else if(reclen > 0)
+        res = decode_records(&in, mode, reclen, single, locking, out);
+    else
+        res = decode_hex_lines(&in, mode, single, locking, out);
+
+    if(output_flush(out))
+        res = -1;
+
+    tiny_cbs_assembler_free(cbs);
+    tiny_utf_parallel_shutdown();
+    input_close(&in);
+    if(opath)
+        close(out->fd);
+    free(out);
+    return res ? 1 : 0;
+}